@@ -0,0 +1,62 @@
+#include <benchmark/benchmark.h>
+#include "backtrace.hh"
+#include "result.hh"
+
+namespace results {
+namespace {
+
+// range(0) is the sampling policy: 0 is off, 1 captures every call, n captures one in n
+
+void backtrace_capture(benchmark::State& state)
+{
+  set_backtrace_sampling(state.range(0));
+  for(auto _ : state)
+  {
+    benchmark::DoNotOptimize(backtrace::capture());
+  }
+  set_backtrace_sampling(0);
+}
+BENCHMARK(backtrace_capture)->Arg(0)->Arg(1)->Arg(64);
+
+void backtrace_make_err(benchmark::State& state)
+{
+  set_backtrace_sampling(state.range(0));
+  for(auto _ : state)
+  {
+    benchmark::DoNotOptimize(make_err<int>("booh"));
+  }
+  set_backtrace_sampling(0);
+}
+BENCHMARK(backtrace_make_err)->Arg(0)->Arg(1)->Arg(64);
+
+void backtrace_panic(benchmark::State& state)
+{
+  set_backtrace_sampling(state.range(0));
+  auto err = make_err<int>("booh");
+  for(auto _ : state)
+  {
+    try
+    {
+      benchmark::DoNotOptimize(err.unwrap());
+    }
+    catch(const panicked& p)
+    {
+      benchmark::DoNotOptimize(&p);
+    }
+  }
+  set_backtrace_sampling(0);
+}
+BENCHMARK(backtrace_panic)->Arg(0)->Arg(1)->Arg(64);
+
+void backtrace_symbolize(benchmark::State& state)
+{
+  auto bt = backtrace::capture_always();
+  for(auto _ : state)
+  {
+    benchmark::DoNotOptimize(bt.to_string());
+  }
+}
+BENCHMARK(backtrace_symbolize);
+
+} // namespace
+} // namespace results
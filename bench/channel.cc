@@ -0,0 +1,122 @@
+#include <benchmark/benchmark.h>
+#include "channel.hh"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace results {
+namespace {
+
+constexpr int items = 100000;
+
+// the pattern channel replaces: a mutex protected deque with a close flag
+class mutex_queue
+{
+public:
+  void push(result<int>&& value)
+  {
+    {
+      std::lock_guard<std::mutex> lock(d_mutex);
+      d_queue.push_back(std::move(value));
+    }
+    d_cv.notify_one();
+  }
+
+  result<int> pop()
+  {
+    std::unique_lock<std::mutex> lock(d_mutex);
+    d_cv.wait(lock, [this] { return !d_queue.empty() || d_closed; });
+    if(d_queue.empty())
+    {
+      return make_err<int>("done");
+    }
+    auto value = std::move(d_queue.front());
+    d_queue.pop_front();
+    return value;
+  }
+
+  void close()
+  {
+    {
+      std::lock_guard<std::mutex> lock(d_mutex);
+      d_closed = true;
+    }
+    d_cv.notify_all();
+  }
+
+private:
+  std::mutex               d_mutex;
+  std::condition_variable  d_cv;
+  std::deque<result<int>> d_queue;
+  bool                     d_closed = false;
+};
+
+// range(0) producers and range(1) consumers move items through the queue, every 64th an error
+template <typename Queue, typename Close>
+void transfer(benchmark::State& state, Queue& q, Close&& close)
+{
+  int producers = state.range(0);
+  int consumers = state.range(1);
+
+  std::vector<std::thread> threads;
+  for(int i = 0; i < consumers; ++i)
+  {
+    threads.emplace_back([&] {
+      for(;;)
+      {
+        auto r = q.pop();
+        if(r.is_err() && r.unwrap_err().msg == "done")
+        {
+          return;
+        }
+      }
+    });
+  }
+
+  std::vector<std::thread> producer_threads;
+  for(int p = 0; p < producers; ++p)
+  {
+    producer_threads.emplace_back([&] {
+      for(int i = 0; i < items / producers; ++i)
+      {
+        q.push(i % 64 == 0 ? make_err<int>("bad") : make_ok<int>(i));
+      }
+    });
+  }
+  for(auto&& t : producer_threads)
+  {
+    t.join();
+  }
+  close();
+  for(auto&& t : threads)
+  {
+    t.join();
+  }
+}
+
+void channel_transfer(benchmark::State& state)
+{
+  for(auto _ : state)
+  {
+    channel<int> c(1024);
+    transfer(state, c, [&] { c.close(error("done")); });
+  }
+  state.SetItemsProcessed(state.iterations() * items);
+}
+BENCHMARK(channel_transfer)->Args({1, 1})->Args({4, 4})->UseRealTime();
+
+void channel_mutex_queue_transfer(benchmark::State& state)
+{
+  for(auto _ : state)
+  {
+    mutex_queue q;
+    transfer(state, q, [&] { q.close(); });
+  }
+  state.SetItemsProcessed(state.iterations() * items);
+}
+BENCHMARK(channel_mutex_queue_transfer)->Args({1, 1})->Args({4, 4})->UseRealTime();
+
+} // namespace
+} // namespace results
@@ -0,0 +1,58 @@
+#include <benchmark/benchmark.h>
+#include "circuit_breaker.hh"
+#include "result.hh"
+#include <chrono>
+
+namespace results {
+namespace {
+
+// The cost a circuit_breaker adds to every call: admitting it and counting its outcome, from several threads sharing
+// one breaker. circuit_breaker_none is the same call without a breaker.
+
+[[gnu::noinline]] result<int, int> backend(int v)
+{
+  return result<int, int>::ok(v);
+}
+
+circuit_breaker<>& shared_breaker()
+{
+  static circuit_breaker<> b;
+  return b;
+}
+
+void circuit_breaker_none(benchmark::State& state)
+{
+  for(auto _ : state)
+  {
+    benchmark::DoNotOptimize(backend(1));
+  }
+}
+BENCHMARK(circuit_breaker_none);
+
+void circuit_breaker_closed(benchmark::State& state)
+{
+  auto& b = shared_breaker();
+  for(auto _ : state)
+  {
+    benchmark::DoNotOptimize(b.run([] { return backend(1); }));
+  }
+}
+BENCHMARK(circuit_breaker_closed)->ThreadRange(1, 4);
+
+void circuit_breaker_open(benchmark::State& state)
+{
+  breaker_policy policy;
+  policy.minimum_calls = 1;
+  policy.open_duration = std::chrono::hours(1);
+  circuit_breaker<> b(policy);
+  b.run([] { return result<int, int>::err(1); });
+
+  for(auto _ : state)
+  {
+    benchmark::DoNotOptimize(b.run([] { return backend(1); }));
+  }
+}
+BENCHMARK(circuit_breaker_open);
+
+} // namespace
+} // namespace results
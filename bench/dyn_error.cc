@@ -0,0 +1,116 @@
+#include <benchmark/benchmark.h>
+#include "dyn_error.hh"
+#include "result.hh"
+#include <array>
+
+namespace results {
+namespace {
+
+// Creating an error and handing it up three frames, for results::error (a string) against dyn_error holding a small
+// error in place, a string, or an error too large to be stored inline.
+
+struct small_error
+{
+  int code;
+};
+
+struct large_error
+{
+  std::array<char, 64> detail;
+  int                  code;
+};
+
+template <typename R, typename F>
+[[gnu::noinline]] R level0(F make)
+{
+  return R::err(make());
+}
+
+template <typename R, typename F>
+[[gnu::noinline]] R level1(F make)
+{
+  auto r = level0<R>(make);
+  return r.is_ok() ? R::ok(r.unwrap() + 1) : r;
+}
+
+template <typename R, typename F>
+[[gnu::noinline]] R level2(F make)
+{
+  return level1<R>(make).map([](int v) { return v * 2; });
+}
+
+void error_create(benchmark::State& state)
+{
+  for(auto _ : state)
+  {
+    benchmark::DoNotOptimize(result<int, error>::err("not found"));
+  }
+}
+BENCHMARK(error_create);
+
+void dyn_error_create_small(benchmark::State& state)
+{
+  for(auto _ : state)
+  {
+    benchmark::DoNotOptimize(dyn_result<int>::err(small_error{1}));
+  }
+}
+BENCHMARK(dyn_error_create_small);
+
+void dyn_error_create_string(benchmark::State& state)
+{
+  for(auto _ : state)
+  {
+    benchmark::DoNotOptimize(dyn_result<int>::err("not found"));
+  }
+}
+BENCHMARK(dyn_error_create_string);
+
+void dyn_error_create_large(benchmark::State& state)
+{
+  for(auto _ : state)
+  {
+    benchmark::DoNotOptimize(dyn_result<int>::err(large_error{{}, 1}));
+  }
+}
+BENCHMARK(dyn_error_create_large);
+
+void error_propagate(benchmark::State& state)
+{
+  for(auto _ : state)
+  {
+    benchmark::DoNotOptimize(level2<result<int, error>>([] { return error("not found"); }));
+  }
+}
+BENCHMARK(error_propagate);
+
+void dyn_error_propagate_small(benchmark::State& state)
+{
+  for(auto _ : state)
+  {
+    benchmark::DoNotOptimize(level2<dyn_result<int>>([] { return small_error{1}; }));
+  }
+}
+BENCHMARK(dyn_error_propagate_small);
+
+void dyn_error_propagate_large(benchmark::State& state)
+{
+  for(auto _ : state)
+  {
+    benchmark::DoNotOptimize(level2<dyn_result<int>>([] { return large_error{{}, 1}; }));
+  }
+}
+BENCHMARK(dyn_error_propagate_large);
+
+void dyn_error_downcast(benchmark::State& state)
+{
+  auto r = dyn_result<int>::err(small_error{1});
+  for(auto _ : state)
+  {
+    benchmark::DoNotOptimize(r.unwrap_err().downcast<small_error>());
+  }
+}
+BENCHMARK(dyn_error_downcast);
+
+} // namespace
+} // namespace results
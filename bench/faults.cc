@@ -0,0 +1,127 @@
+#include <benchmark/benchmark.h>
+#include "faults.hh"
+#include "option.hh"
+#include "result.hh"
+#include <cstdint>
+#include <source_location>
+#include <vector>
+
+namespace results {
+namespace {
+
+// Throughput of the combinators of result and option as the error rate grows, swept in errors per 10000 elements.
+// Inputs are produced up front under a seeded fault_policy, so the timed loop holds only the combinators and every
+// run sees the same failures. The decisions are taken through internal::should_fault() before any input is built, so
+// that the sweep runs the same with and without RESULTS_FAULTS, which would also fail the ok() calls.
+
+constexpr std::size_t elements = 4096;
+
+template <typename F>
+auto produce(std::int64_t per_10000, F&& make)
+{
+  set_fault_policy({double(per_10000) / 10000, 1});
+  const auto        site = std::source_location::current();
+  std::vector<bool> faults;
+  for(std::size_t i = 0; i < elements; ++i)
+  {
+    faults.push_back(internal::should_fault(site));
+  }
+  set_fault_policy({});
+
+  std::vector<decltype(make(0, false))> inputs;
+  inputs.reserve(elements);
+  for(std::size_t i = 0; i < elements; ++i)
+  {
+    inputs.push_back(make(static_cast<int>(i), faults[i]));
+  }
+  return inputs;
+}
+
+std::vector<result<int>> results_at(std::int64_t per_10000)
+{
+  return produce(per_10000, [](int v, bool fault) {
+    return fault ? result<int>::err("injected fault: connection reset by peer") : result<int>::ok(v);
+  });
+}
+
+std::vector<option<int>> options_at(std::int64_t per_10000)
+{
+  return produce(per_10000, [](int v, bool fault) { return fault ? option<int>::none() : option<int>::some(v); });
+}
+
+void sweep(benchmark::internal::Benchmark* b)
+{
+  for(auto per_10000 : {0, 1, 10, 100, 1000, 5000, 10000})
+  {
+    b->Arg(per_10000);
+  }
+}
+
+void faults_result_chain(benchmark::State& state)
+{
+  const auto inputs = results_at(state.range(0));
+  for(auto _ : state)
+  {
+    std::int64_t sum = 0;
+    for(const auto& r : inputs)
+    {
+      sum += r.map([](int v) { return v * 3; })
+                 .and_then([](int v) { return v % 5 == 0 ? result<int>::err("multiple of five") : result<int>::ok(v); })
+                 .unwrap_or(0);
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * elements);
+}
+BENCHMARK(faults_result_chain)->Apply(sweep);
+
+void faults_result_recover(benchmark::State& state)
+{
+  const auto inputs = results_at(state.range(0));
+  for(auto _ : state)
+  {
+    std::int64_t sum = 0;
+    for(const auto& r : inputs)
+    {
+      sum += r.map_err([](const error& e) { return e.msg.size(); })
+                 .match([](int v) { return v; }, [](std::size_t n) { return -static_cast<int>(n); });
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * elements);
+}
+BENCHMARK(faults_result_recover)->Apply(sweep);
+
+void faults_option_chain(benchmark::State& state)
+{
+  const auto inputs = options_at(state.range(0));
+  for(auto _ : state)
+  {
+    std::int64_t sum = 0;
+    for(const auto& o : inputs)
+    {
+      sum += o.map([](int v) { return v * 3; })
+                 .filter([](int v) { return v % 5 != 0; })
+                 .and_then([](int v) { return option<int>::some(v + 1); })
+                 .unwrap_or(0);
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * elements);
+}
+BENCHMARK(faults_option_chain)->Apply(sweep);
+
+void faults_should_fault(benchmark::State& state)
+{
+  set_fault_policy({double(state.range(0)) / 10000, 1});
+  const auto site = std::source_location::current();
+  for(auto _ : state)
+  {
+    benchmark::DoNotOptimize(internal::should_fault(site));
+  }
+  set_fault_policy({});
+}
+BENCHMARK(faults_should_fault)->Arg(0)->Arg(100);
+
+} // namespace
+} // namespace results
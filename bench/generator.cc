@@ -0,0 +1,99 @@
+#include <benchmark/benchmark.h>
+#include "generator.hh"
+#include "parse.hh"
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace results {
+namespace {
+
+// range(0) is the number of lines, every 16th line does not parse
+
+std::string make_input(std::size_t lines)
+{
+  std::string input;
+  for(std::size_t i = 0; i < lines; ++i)
+  {
+    input += (i % 16 == 15) ? "garbage" : std::to_string(i);
+    input += '\n';
+  }
+  return input;
+}
+
+template <typename F>
+void for_each_line(std::string_view input, F&& f)
+{
+  while(!input.empty())
+  {
+    auto eol = input.find('\n');
+    f(input.substr(0, eol));
+    input.remove_prefix(eol == std::string_view::npos ? input.size() : eol + 1);
+  }
+}
+
+std::vector<result<int, parse_error>> parse_all(std::string_view input)
+{
+  std::vector<result<int, parse_error>> records;
+  for_each_line(input, [&](std::string_view line) { records.push_back(parse<int>(line)); });
+  return records;
+}
+
+result_generator<int, parse_error> parse_lazily(std::string_view input)
+{
+  while(!input.empty())
+  {
+    auto eol = input.find('\n');
+    co_yield parse<int>(input.substr(0, eol));
+    input.remove_prefix(eol == std::string_view::npos ? input.size() : eol + 1);
+  }
+}
+
+void generator_vector(benchmark::State& state)
+{
+  auto input = make_input(state.range(0));
+  for(auto _ : state)
+  {
+    long sum = 0;
+    for(const auto& r : parse_all(input))
+    {
+      sum += r.is_ok() ? r.unwrap_unchecked() : -1;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(generator_vector)->Arg(1 << 10)->Arg(1 << 20);
+
+void generator_coroutine(benchmark::State& state)
+{
+  auto input = make_input(state.range(0));
+  for(auto _ : state)
+  {
+    long sum = 0;
+    for(const auto& r : parse_lazily(input))
+    {
+      sum += r.is_ok() ? r.unwrap_unchecked() : -1;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(generator_coroutine)->Arg(1 << 10)->Arg(1 << 20);
+
+// many short streams, where recycling the coroutine frame matters
+void generator_short_streams(benchmark::State& state)
+{
+  auto input = make_input(4);
+  for(auto _ : state)
+  {
+    for(const auto& r : parse_lazily(input))
+    {
+      benchmark::DoNotOptimize(r);
+    }
+  }
+}
+BENCHMARK(generator_short_streams);
+
+} // namespace
+} // namespace results
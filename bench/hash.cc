@@ -0,0 +1,53 @@
+#include <benchmark/benchmark.h>
+#include "option.hh"
+#include "result.hh"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace results {
+namespace {
+
+// lookups in a map of range(0) keys, every tenth key is none or err
+
+void hash_option_int_lookup(benchmark::State& state)
+{
+  std::unordered_map<option<int>, int> m;
+  std::vector<option<int>>             keys;
+  for(int i = 0; i < state.range(0); ++i)
+  {
+    keys.push_back(i % 10 == 0 ? make_none<int>() : make_some<int>(i));
+    m[keys.back()] = i;
+  }
+
+  std::size_t idx = 0;
+  for(auto _ : state)
+  {
+    benchmark::DoNotOptimize(m.find(keys[idx]));
+    idx = idx + 1 == keys.size() ? 0 : idx + 1;
+  }
+}
+BENCHMARK(hash_option_int_lookup)->Arg(64)->Arg(4096);
+
+void hash_result_string_lookup(benchmark::State& state)
+{
+  std::unordered_map<result<std::string>, int> m;
+  std::vector<result<std::string>>             keys;
+  for(int i = 0; i < state.range(0); ++i)
+  {
+    auto s = "key number " + std::to_string(i);
+    keys.push_back(i % 10 == 0 ? make_err<std::string>(s) : make_ok<std::string>(s));
+    m[keys.back()] = i;
+  }
+
+  std::size_t idx = 0;
+  for(auto _ : state)
+  {
+    benchmark::DoNotOptimize(m.find(keys[idx]));
+    idx = idx + 1 == keys.size() ? 0 : idx + 1;
+  }
+}
+BENCHMARK(hash_result_string_lookup)->Arg(64)->Arg(4096);
+
+} // namespace
+} // namespace results
@@ -0,0 +1,42 @@
+#include <benchmark/benchmark.h>
+#include "instrument.hh"
+#include "result.hh"
+#include <source_location>
+
+namespace results {
+namespace {
+
+// The cost of one counted call, paid by ok(), err() and expect() when built with RESULTS_INSTRUMENT. Compare
+// instrument_err against a build without it to see the end to end overhead.
+
+void instrument_count_site(benchmark::State& state)
+{
+  const auto site = std::source_location::current();
+  for(auto _ : state)
+  {
+    internal::count_site(site_kind::err, site);
+  }
+}
+BENCHMARK(instrument_count_site)->ThreadRange(1, 4);
+
+void instrument_err(benchmark::State& state)
+{
+  for(auto _ : state)
+  {
+    benchmark::DoNotOptimize(result<int, int>::err(1));
+  }
+}
+BENCHMARK(instrument_err);
+
+void instrument_expect(benchmark::State& state)
+{
+  auto r = result<int, int>::ok(1);
+  for(auto _ : state)
+  {
+    benchmark::DoNotOptimize(r.expect("ok"));
+  }
+}
+BENCHMARK(instrument_expect);
+
+} // namespace
+} // namespace results
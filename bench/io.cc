@@ -0,0 +1,109 @@
+#include <benchmark/benchmark.h>
+#include "io.hh"
+#include "result.hh"
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <unistd.h>
+
+namespace results {
+namespace {
+
+// Reading a whole file and failing on a missing one: map_file() against the pattern it replaces, a throwing ifstream
+// wrapped in make_from_throwable() that copies the content into a string.
+
+std::string read_with_ifstream(const std::filesystem::path& path)
+{
+  std::ifstream in;
+  in.exceptions(std::ios::failbit | std::ios::badbit);
+  in.open(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+// a file of the benchmark's argument in bytes, removed with the fixture
+class file_fixture
+{
+public:
+  explicit file_fixture(std::size_t size)
+    : d_path(std::filesystem::temp_directory_path() / ("results_bench_io_" + std::to_string(::getpid())))
+  {
+    std::ofstream out(d_path, std::ios::binary);
+    out << std::string(size, 'x');
+  }
+
+  ~file_fixture()
+  {
+    std::filesystem::remove(d_path);
+  }
+
+  const std::filesystem::path& path() const noexcept
+  {
+    return d_path;
+  }
+
+private:
+  std::filesystem::path d_path;
+};
+
+void io_ifstream_read(benchmark::State& state)
+{
+  file_fixture f(static_cast<std::size_t>(state.range(0)));
+  for(auto _ : state)
+  {
+    benchmark::DoNotOptimize(make_from_throwable([&] { return read_with_ifstream(f.path()); }));
+  }
+}
+BENCHMARK(io_ifstream_read)->Range(64, 1 << 20);
+
+void io_map_file(benchmark::State& state)
+{
+  file_fixture f(static_cast<std::size_t>(state.range(0)));
+  for(auto _ : state)
+  {
+    auto view = io::map_file(f.path());
+    // touch every page, as a reader of the content would
+    std::size_t sum = 0;
+    for(std::size_t i = 0; i < view.unwrap().size(); i += 4096)
+    {
+      sum += static_cast<std::size_t>(view.unwrap().data()[i]);
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+}
+BENCHMARK(io_map_file)->Range(64, 1 << 20);
+
+void io_read_at(benchmark::State& state)
+{
+  file_fixture f(static_cast<std::size_t>(state.range(0)));
+  auto         file = io::file::open(f.path());
+  std::string  buffer(static_cast<std::size_t>(state.range(0)), '\0');
+  for(auto _ : state)
+  {
+    benchmark::DoNotOptimize(io::read_at(file.unwrap(), std::as_writable_bytes(std::span<char>(buffer)), 0));
+  }
+}
+BENCHMARK(io_read_at)->Range(64, 1 << 20);
+
+void io_ifstream_missing(benchmark::State& state)
+{
+  std::filesystem::path path("/nonexistent/results_bench_io");
+  for(auto _ : state)
+  {
+    benchmark::DoNotOptimize(make_from_throwable([&] { return read_with_ifstream(path); }));
+  }
+}
+BENCHMARK(io_ifstream_missing);
+
+void io_map_file_missing(benchmark::State& state)
+{
+  std::filesystem::path path("/nonexistent/results_bench_io");
+  for(auto _ : state)
+  {
+    benchmark::DoNotOptimize(io::map_file(path));
+  }
+}
+BENCHMARK(io_map_file_missing);
+
+} // namespace
+} // namespace results
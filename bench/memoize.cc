@@ -0,0 +1,52 @@
+#include <benchmark/benchmark.h>
+#include "memoize.hh"
+#include <atomic>
+#include <string>
+
+namespace results {
+namespace {
+
+result<std::string> lookup(int key)
+{
+  if(key % 4 == 0)
+  {
+    return make_err<std::string>("not found");
+  }
+  return make_ok<std::string>("value for key " + std::to_string(key));
+}
+
+memoize<int, result<std::string>>& shared_cache()
+{
+  static memoize<int, result<std::string>> cache(lookup);
+  return cache;
+}
+
+// every thread cycles through 256 keys that all fit in the cache
+void memoize_hit(benchmark::State& state)
+{
+  auto&     cache = shared_cache();
+  const int first = state.thread_index() * 256;
+  int       i     = 0;
+  for(auto _ : state)
+  {
+    benchmark::DoNotOptimize(cache.get(first + i));
+    i = (i + 1) % 256;
+  }
+}
+BENCHMARK(memoize_hit)->Threads(1)->Threads(4);
+
+// every call is for a fresh key, so each get computes and evicts
+void memoize_miss(benchmark::State& state)
+{
+  static std::atomic<int> next{1 << 20};
+
+  auto& cache = shared_cache();
+  for(auto _ : state)
+  {
+    benchmark::DoNotOptimize(cache.get(next.fetch_add(1, std::memory_order_relaxed)));
+  }
+}
+BENCHMARK(memoize_miss)->Threads(1)->Threads(4);
+
+} // namespace
+} // namespace results
@@ -0,0 +1,33 @@
+#include <benchmark/benchmark.h>
+#include "parse.hh"
+#include <string>
+
+namespace results {
+namespace {
+
+// range(0) selects the input: 0 is a valid integer, 1 is garbage
+
+const std::string inputs[] = {"123456", "not a number"};
+
+void parse_from_chars(benchmark::State& state)
+{
+  const auto& input = inputs[state.range(0)];
+  for(auto _ : state)
+  {
+    benchmark::DoNotOptimize(parse<int>(input));
+  }
+}
+BENCHMARK(parse_from_chars)->Arg(0)->Arg(1);
+
+void parse_make_from_throwable_stoi(benchmark::State& state)
+{
+  const auto& input = inputs[state.range(0)];
+  for(auto _ : state)
+  {
+    benchmark::DoNotOptimize(make_from_throwable([&] { return std::stoi(input); }));
+  }
+}
+BENCHMARK(parse_make_from_throwable_stoi)->Arg(0)->Arg(1);
+
+} // namespace
+} // namespace results
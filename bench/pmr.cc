@@ -0,0 +1,50 @@
+#include <benchmark/benchmark.h>
+#include "pmr.hh"
+#include <array>
+#include <memory_resource>
+#include <vector>
+
+namespace results {
+namespace {
+
+// a request that produces range(0) results, every other one an error with a heap-sized message
+
+constexpr auto msg = "backend unavailable: connection refused while fetching configuration";
+
+void pmr_global_heap(benchmark::State& state)
+{
+  for(auto _ : state)
+  {
+    std::vector<result<int>> results;
+    for(int i = 0; i < state.range(0); ++i)
+    {
+      results.push_back(i % 2 == 0 ? make_ok<int>(i) : make_err<int>(msg));
+    }
+    benchmark::DoNotOptimize(results.data());
+  }
+}
+BENCHMARK(pmr_global_heap)->Arg(16)->Arg(256);
+
+void pmr_arena(benchmark::State& state)
+{
+  std::array<std::byte, 64 * 1024>   buffer;
+  std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size());
+
+  for(auto _ : state)
+  {
+    {
+      std::pmr::vector<pmr::result<int>> results(&arena);
+      for(int i = 0; i < state.range(0); ++i)
+      {
+        results.push_back(i % 2 == 0 ? make_ok<int, pmr::error>(std::allocator_arg, &arena, i)
+                                     : make_err<int, pmr::error>(std::allocator_arg, &arena, msg));
+      }
+      benchmark::DoNotOptimize(results.data());
+    }
+    arena.release();
+  }
+}
+BENCHMARK(pmr_arena)->Arg(16)->Arg(256);
+
+} // namespace
+} // namespace results
@@ -0,0 +1,46 @@
+#include <benchmark/benchmark.h>
+#include "recorder.hh"
+#include "result.hh"
+#include <source_location>
+
+namespace results {
+namespace {
+
+// The cost of one record, paid by err(), make_err() and make_from_throwable() when built with RESULTS_RECORD.
+// Compare recorder_err against a build without it to see the end to end overhead.
+
+void recorder_record_error(benchmark::State& state)
+{
+  const auto site = std::source_location::current();
+  for(auto _ : state)
+  {
+    internal::record_error(record_kind::err, site, 1, "connection refused");
+  }
+}
+BENCHMARK(recorder_record_error)->ThreadRange(1, 4);
+
+void recorder_err(benchmark::State& state)
+{
+  for(auto _ : state)
+  {
+    benchmark::DoNotOptimize(result<int, int>::err(1));
+  }
+}
+BENCHMARK(recorder_err);
+
+void recorder_dump(benchmark::State& state)
+{
+  const auto site = std::source_location::current();
+  for(int i = 0; i < 4096; ++i)
+  {
+    internal::record_error(record_kind::err, site, i, "connection refused");
+  }
+  for(auto _ : state)
+  {
+    benchmark::DoNotOptimize(dump_error_records());
+  }
+}
+BENCHMARK(recorder_dump);
+
+} // namespace
+} // namespace results
@@ -0,0 +1,120 @@
+#include <benchmark/benchmark.h>
+#include "result_array.hh"
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace results {
+namespace {
+
+// result_array against std::vector<result<T, E>> for a bulk transform at error rates given in errors per 10000
+// elements. The bytes counter reports the memory each container holds.
+
+constexpr std::size_t elements = 1 << 16;
+
+using value_result = result<double, std::string>;
+
+bool fails(std::mt19937_64& rng, std::int64_t per_10000)
+{
+  return static_cast<std::int64_t>(rng() % 10000) < per_10000;
+}
+
+std::vector<value_result> make_vector(std::int64_t per_10000)
+{
+  std::mt19937_64           rng(1);
+  std::vector<value_result> v;
+  v.reserve(elements);
+  for(std::size_t i = 0; i < elements; ++i)
+  {
+    v.push_back(fails(rng, per_10000) ? value_result::err("parse failure") : value_result::ok(double(i)));
+  }
+  return v;
+}
+
+result_array<double, std::string> make_array(std::int64_t per_10000)
+{
+  std::mt19937_64                   rng(1);
+  result_array<double, std::string> a;
+  a.reserve(elements);
+  for(std::size_t i = 0; i < elements; ++i)
+  {
+    if(fails(rng, per_10000))
+    {
+      a.emplace_err("parse failure");
+    }
+    else
+    {
+      a.emplace_ok(double(i));
+    }
+  }
+  return a;
+}
+
+void result_array_vector_map(benchmark::State& state)
+{
+  auto v = make_vector(state.range(0));
+  for(auto _ : state)
+  {
+    std::vector<result<double, std::string>> out;
+    out.reserve(v.size());
+    for(const auto& r : v)
+    {
+      out.push_back(r.map([](double x) { return x * 1.5 + 1; }));
+    }
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * elements);
+  state.counters["bytes"] = double(v.capacity() * sizeof(value_result));
+}
+BENCHMARK(result_array_vector_map)->Arg(0)->Arg(1)->Arg(10)->Arg(100)->Arg(1000);
+
+void result_array_map(benchmark::State& state)
+{
+  auto a = make_array(state.range(0));
+  for(auto _ : state)
+  {
+    auto out = a.map([](double x) { return x * 1.5 + 1; });
+    benchmark::DoNotOptimize(out.values().data());
+  }
+  state.SetItemsProcessed(state.iterations() * elements);
+  state.counters["bytes"] = double(a.size() * sizeof(double) + a.error_bits().size_bytes() +
+                                   a.error_count() * sizeof(std::pair<std::size_t, std::string>));
+}
+BENCHMARK(result_array_map)->Arg(0)->Arg(1)->Arg(10)->Arg(100)->Arg(1000);
+
+void result_array_vector_sum(benchmark::State& state)
+{
+  auto v = make_vector(state.range(0));
+  for(auto _ : state)
+  {
+    double sum = 0;
+    for(const auto& r : v)
+    {
+      sum += r.is_ok() ? r.unwrap_unchecked() : 0;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * elements);
+}
+BENCHMARK(result_array_vector_sum)->Arg(0)->Arg(10)->Arg(1000);
+
+void result_array_sum(benchmark::State& state)
+{
+  auto a = make_array(state.range(0));
+  for(auto _ : state)
+  {
+    // failed elements hold 0, the dense values can be summed as they are
+    double sum = 0;
+    for(double x : a.values())
+    {
+      sum += x;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * elements);
+}
+BENCHMARK(result_array_sum)->Arg(0)->Arg(10)->Arg(1000);
+
+} // namespace
+} // namespace results
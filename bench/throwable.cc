@@ -0,0 +1,56 @@
+#include <benchmark/benchmark.h>
+#include "result.hh"
+#include <stdexcept>
+
+namespace results {
+namespace {
+
+int throws()
+{
+  throw std::runtime_error("a message long enough to defeat the small string optimization");
+}
+
+int does_not_throw() noexcept
+{
+  return 42;
+}
+
+void throwable_what_copy(benchmark::State& state)
+{
+  for(auto _ : state)
+  {
+    benchmark::DoNotOptimize(make_from_throwable(throws));
+  }
+}
+BENCHMARK(throwable_what_copy);
+
+void throwable_exception_ptr(benchmark::State& state)
+{
+  for(auto _ : state)
+  {
+    benchmark::DoNotOptimize(make_from_exception(throws));
+  }
+}
+BENCHMARK(throwable_exception_ptr);
+
+void throwable_exception_what(benchmark::State& state)
+{
+  const auto err = make_from_exception(throws).unwrap_err();
+  for(auto _ : state)
+  {
+    benchmark::DoNotOptimize(err.what());
+  }
+}
+BENCHMARK(throwable_exception_what);
+
+void throwable_noexcept(benchmark::State& state)
+{
+  for(auto _ : state)
+  {
+    benchmark::DoNotOptimize(make_from_throwable(does_not_throw));
+  }
+}
+BENCHMARK(throwable_noexcept);
+
+} // namespace
+} // namespace results
@@ -0,0 +1,63 @@
+#include <benchmark/benchmark.h>
+#include "trace.hh"
+#include "result.hh"
+
+namespace results {
+namespace {
+
+// The cost of tracing one step of a result chain. trace_record_span is the buffer write every finished span pays,
+// whatever the build; trace_chain and trace_chain_untraced compare a traced and a plain chain, equal in a build without
+// RESULTS_TRACE and apart by two spans with it.
+
+[[gnu::noinline]] result<int, int> parse(int v)
+{
+  return v > 0 ? result<int, int>::ok(v) : result<int, int>::err(v);
+}
+
+int twice(int v)
+{
+  return v * 2;
+}
+
+void trace_record_span(benchmark::State& state)
+{
+  for(auto _ : state)
+  {
+    internal::record_span("step", internal::timestamp(), internal::timestamp(), span_outcome::ok);
+  }
+}
+BENCHMARK(trace_record_span)->ThreadRange(1, 4);
+
+void trace_chain_untraced(benchmark::State& state)
+{
+  for(auto _ : state)
+  {
+    benchmark::DoNotOptimize(result<int, int>::ok(3).and_then(parse).map(twice));
+  }
+}
+BENCHMARK(trace_chain_untraced);
+
+void trace_chain(benchmark::State& state)
+{
+  for(auto _ : state)
+  {
+    benchmark::DoNotOptimize(result<int, int>::ok(3).and_then(traced("parse", parse)).map(traced("twice", twice)));
+  }
+}
+BENCHMARK(trace_chain);
+
+void trace_snapshot(benchmark::State& state)
+{
+  for(int i = 0; i < 4096; ++i)
+  {
+    internal::record_span("step", internal::timestamp(), internal::timestamp(), span_outcome::ok);
+  }
+  for(auto _ : state)
+  {
+    benchmark::DoNotOptimize(snapshot_trace());
+  }
+}
+BENCHMARK(trace_snapshot);
+
+} // namespace
+} // namespace results
@@ -0,0 +1,142 @@
+#include "backtrace.hh"
+#include <atomic>
+#include <cstdlib>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <memory>
+#include <ostream>
+#include <sstream>
+#include <unwind.h>
+
+namespace results {
+namespace {
+
+std::atomic<unsigned> s_sampling{0};
+
+struct unwind_state
+{
+  void**      frames;
+  std::size_t capacity;
+  std::size_t skip;
+  std::size_t size;
+};
+
+_Unwind_Reason_Code collect(_Unwind_Context* ctx, void* arg)
+{
+  auto* state = static_cast<unwind_state*>(arg);
+
+  auto ip = _Unwind_GetIP(ctx);
+  if(ip == 0)
+  {
+    return _URC_END_OF_STACK;
+  }
+  if(state->skip > 0)
+  {
+    --state->skip;
+    return _URC_NO_REASON;
+  }
+  state->frames[state->size++] = reinterpret_cast<void*>(ip);
+  return state->size < state->capacity ? _URC_NO_REASON : _URC_END_OF_STACK;
+}
+
+// the skip count includes this function itself
+[[gnu::noinline]] std::size_t unwind(void** frames, std::size_t capacity, std::size_t skip) noexcept
+{
+  unwind_state state{frames, capacity, skip + 1, 0};
+  _Unwind_Backtrace(collect, &state);
+  return state.size;
+}
+
+bool sampled() noexcept
+{
+  auto every_n = s_sampling.load(std::memory_order_relaxed);
+  if(every_n == 0)
+  {
+    return false;
+  }
+
+  thread_local unsigned count = 0;
+  if(++count < every_n)
+  {
+    return false;
+  }
+  count = 0;
+  return true;
+}
+
+void symbolize(std::ostream& os, std::size_t idx, void* frame)
+{
+  // return addresses point past the call, look up the call instruction itself
+  auto* addr = static_cast<char*>(frame) - 1;
+
+  os << '#' << idx << ' ' << frame;
+
+  Dl_info info{};
+  if(dladdr(addr, &info) == 0)
+  {
+    os << '\n';
+    return;
+  }
+
+  if(info.dli_sname != nullptr)
+  {
+    int                                    status = 0;
+    std::unique_ptr<char, void (*)(void*)> demangled(abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status), std::free);
+
+    os << ' ' << (status == 0 ? demangled.get() : info.dli_sname)
+       << "+0x" << std::hex << (addr - static_cast<char*>(info.dli_saddr)) << std::dec;
+  }
+  if(info.dli_fname != nullptr)
+  {
+    os << " in " << info.dli_fname
+       << " (+0x" << std::hex << (addr - static_cast<char*>(info.dli_fbase)) << std::dec << ')';
+  }
+  os << '\n';
+}
+
+} // namespace
+
+[[gnu::noinline]] backtrace backtrace::capture() noexcept
+{
+  backtrace bt;
+  if(sampled())
+  {
+    bt.d_size = unwind(bt.d_frames.data(), max_frames, 1);
+  }
+  return bt;
+}
+
+[[gnu::noinline]] backtrace backtrace::capture_always() noexcept
+{
+  backtrace bt;
+  bt.d_size = unwind(bt.d_frames.data(), max_frames, 1);
+  return bt;
+}
+
+std::string backtrace::to_string() const
+{
+  std::ostringstream os;
+  os << *this;
+  return os.str();
+}
+
+std::ostream& operator<<(std::ostream& os, const backtrace& bt)
+{
+  for(std::size_t i = 0; i < bt.size(); ++i)
+  {
+    symbolize(os, i, bt[i]);
+  }
+  return os;
+}
+
+void set_backtrace_sampling(unsigned every_n) noexcept
+{
+  s_sampling.store(every_n, std::memory_order_relaxed);
+}
+
+unsigned backtrace_sampling() noexcept
+{
+  return s_sampling.load(std::memory_order_relaxed);
+}
+
+} // namespace results
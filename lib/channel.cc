@@ -0,0 +1,38 @@
+#include "channel.hh"
+#include <thread>
+
+#ifdef __linux__
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace results {
+namespace internal {
+
+static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t), "futex needs a plain 32 bit word");
+
+void wait_on(const std::atomic<std::uint32_t>& word, std::uint32_t old) noexcept
+{
+#ifdef __linux__
+  syscall(SYS_futex, reinterpret_cast<const std::uint32_t*>(&word), FUTEX_WAIT_PRIVATE, old, nullptr, nullptr, 0);
+#else
+  if(word.load(std::memory_order_acquire) == old)
+  {
+    std::this_thread::yield();
+  }
+#endif
+}
+
+void wake_all(std::atomic<std::uint32_t>& word) noexcept
+{
+#ifdef __linux__
+  syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#else
+  (void)word;
+#endif
+}
+
+} // namespace internal
+} // namespace results
@@ -0,0 +1,94 @@
+#include "dyn_error.hh"
+
+namespace results {
+
+dyn_error::dyn_error() noexcept
+  : d_table(nullptr)
+{
+}
+
+dyn_error::dyn_error(const dyn_error& other)
+  : d_table(nullptr)
+{
+  if(other.d_table)
+  {
+    if(!other.d_table->copy)
+    {
+      internal::panic("copying a dyn_error that holds a move-only error");
+    }
+    other.d_table->copy(other.d_storage, d_storage);
+    d_table = other.d_table;
+  }
+}
+
+dyn_error::dyn_error(dyn_error&& other) noexcept
+  : d_table(other.d_table)
+{
+  if(d_table)
+  {
+    d_table->move(other.d_storage, d_storage);
+    other.d_table = nullptr;
+  }
+}
+
+dyn_error& dyn_error::operator=(const dyn_error& other)
+{
+  if(this != &other)
+  {
+    // copy first, a throwing copy leaves this untouched
+    dyn_error copy(other);
+    *this = std::move(copy);
+  }
+  return *this;
+}
+
+dyn_error& dyn_error::operator=(dyn_error&& other) noexcept
+{
+  if(this != &other)
+  {
+    reset();
+    if(other.d_table)
+    {
+      other.d_table->move(other.d_storage, d_storage);
+      d_table       = other.d_table;
+      other.d_table = nullptr;
+    }
+  }
+  return *this;
+}
+
+dyn_error::~dyn_error()
+{
+  reset();
+}
+
+bool dyn_error::empty() const noexcept
+{
+  return d_table == nullptr;
+}
+
+bool dyn_error::is_inline() const noexcept
+{
+  return d_table && d_table->stored_inline;
+}
+
+bool dyn_error::is_copyable() const noexcept
+{
+  return !d_table || d_table->copy;
+}
+
+std::string dyn_error::message() const
+{
+  return d_table ? d_table->message(d_table->get(d_storage)) : std::string();
+}
+
+void dyn_error::reset() noexcept
+{
+  if(d_table)
+  {
+    d_table->destroy(d_storage);
+    d_table = nullptr;
+  }
+}
+
+} // namespace results
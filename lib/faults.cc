@@ -0,0 +1,130 @@
+#include "faults.hh"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <mutex>
+#include <string_view>
+
+namespace results {
+namespace internal {
+namespace {
+
+struct policy_store
+{
+  std::mutex    mutex;
+  fault_policy  policy;
+  std::uint64_t threshold = 0; // a production fails when its hash is below
+  bool          always    = false;
+};
+
+policy_store& global_policy()
+{
+  static auto* p = new policy_store; // never destroyed, threads may fault after static destruction
+  return *p;
+}
+
+// bumped by every set_fault_policy(), threads reload the policy and restart their sequence when it changes
+std::atomic<std::uint64_t> s_epoch{0};
+std::atomic<std::uint64_t> s_injected{0};
+
+// the policy as seen by one thread
+struct thread_state
+{
+  std::uint64_t epoch     = 0;
+  std::uint64_t threshold = 0;
+  std::uint64_t seed      = 0;
+  bool          always    = false;
+  std::uint64_t sequence  = 0;
+
+  // hash of the last file name seen, file names are static strings
+  const char*   file      = nullptr;
+  std::uint64_t file_hash = 0;
+};
+
+thread_local thread_state s_thread;
+
+std::uint64_t mix(std::uint64_t x) noexcept
+{
+  // the splitmix64 finalizer
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ull;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebull;
+  x ^= x >> 31;
+  return x;
+}
+
+// of the file's name rather than its address, which changes from run to run
+std::uint64_t hash_file(const char* file) noexcept
+{
+  std::uint64_t h = 0xcbf29ce484222325ull;
+  for(unsigned char c : std::string_view(file))
+  {
+    h = (h ^ c) * 0x100000001b3ull;
+  }
+  return h;
+}
+
+} // namespace
+
+bool should_fault(const std::source_location& site) noexcept
+{
+  auto& t     = s_thread;
+  auto  epoch = s_epoch.load(std::memory_order_acquire);
+  if(t.epoch != epoch)
+  {
+    auto&                       p = global_policy();
+    std::lock_guard<std::mutex> lock(p.mutex);
+    t.epoch     = s_epoch.load(std::memory_order_relaxed);
+    t.threshold = p.threshold;
+    t.seed      = p.policy.seed;
+    t.always    = p.always;
+    t.sequence  = 0;
+  }
+  if(t.threshold == 0 && !t.always)
+  {
+    return false;
+  }
+
+  if(t.file != site.file_name())
+  {
+    t.file      = site.file_name();
+    t.file_hash = hash_file(site.file_name());
+  }
+  auto key  = t.file_hash ^ (std::uint64_t(site.line()) << 32 | site.column());
+  auto hash = mix(mix(key ^ t.seed) + t.sequence++);
+  if(!t.always && hash >= t.threshold)
+  {
+    return false;
+  }
+  s_injected.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+} // namespace internal
+
+void set_fault_policy(const fault_policy& policy) noexcept
+{
+  auto&                       p = internal::global_policy();
+  std::lock_guard<std::mutex> lock(p.mutex);
+
+  const auto rate = std::isnan(policy.rate) ? 0.0 : std::clamp(policy.rate, 0.0, 1.0);
+  p.policy        = {rate, policy.seed};
+  p.always        = rate >= 1;
+  p.threshold     = p.always ? 0 : static_cast<std::uint64_t>(std::ldexp(rate, 64));
+  internal::s_epoch.fetch_add(1, std::memory_order_release);
+}
+
+fault_policy get_fault_policy() noexcept
+{
+  auto&                       p = internal::global_policy();
+  std::lock_guard<std::mutex> lock(p.mutex);
+  return p.policy;
+}
+
+std::uint64_t injected_faults() noexcept
+{
+  return internal::s_injected.load(std::memory_order_relaxed);
+}
+
+} // namespace results
@@ -0,0 +1,76 @@
+#include "generator.hh"
+#include <array>
+#include <new>
+
+namespace results {
+namespace internal {
+namespace {
+
+constexpr std::size_t granularity    = 64;
+constexpr std::size_t size_classes   = 16; // frames up to 1 KiB are recycled
+constexpr std::size_t max_free_count = 32; // per size class and thread
+
+struct free_frame
+{
+  free_frame* next;
+};
+
+// cached frames go back to the global allocator when the thread exits
+struct frame_cache
+{
+  std::array<free_frame*, size_classes> heads{};
+  std::array<std::size_t, size_classes> counts{};
+
+  ~frame_cache()
+  {
+    for(auto* head : heads)
+    {
+      while(head != nullptr)
+      {
+        ::operator delete(std::exchange(head, head->next));
+      }
+    }
+  }
+};
+
+thread_local frame_cache s_cache;
+
+std::size_t size_class(std::size_t size) noexcept
+{
+  return (size + granularity - 1) / granularity - 1;
+}
+
+} // namespace
+
+void* allocate_frame(std::size_t size)
+{
+  auto cls = size_class(size);
+  if(cls >= size_classes)
+  {
+    return ::operator new(size);
+  }
+
+  if(auto* frame = s_cache.heads[cls])
+  {
+    s_cache.heads[cls] = frame->next;
+    --s_cache.counts[cls];
+    return frame;
+  }
+  return ::operator new((cls + 1) * granularity);
+}
+
+void deallocate_frame(void* ptr, std::size_t size) noexcept
+{
+  auto cls = size_class(size);
+  if(cls >= size_classes || s_cache.counts[cls] >= max_free_count)
+  {
+    ::operator delete(ptr);
+    return;
+  }
+
+  s_cache.heads[cls] = ::new(ptr) free_frame{s_cache.heads[cls]};
+  ++s_cache.counts[cls];
+}
+
+} // namespace internal
+} // namespace results
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+
+namespace results {
+
+// Raw return addresses of a call stack, stored in a fixed inline array so that capturing never allocates.
+// Symbolization is deferred until the backtrace is printed.
+class backtrace
+{
+public:
+  static constexpr std::size_t max_frames = 32;
+
+  constexpr backtrace() noexcept = default;
+
+  // capture the calling stack if the process-wide sampling policy selects this call, an empty backtrace otherwise
+  static backtrace capture() noexcept;
+
+  // capture the calling stack regardless of the sampling policy
+  static backtrace capture_always() noexcept;
+
+  // info
+  constexpr bool empty() const noexcept;
+
+  constexpr std::size_t size() const noexcept;
+
+  // raw access
+  constexpr void* operator[](std::size_t idx) const noexcept;
+
+  constexpr void* const* begin() const noexcept;
+
+  constexpr void* const* end() const noexcept;
+
+  // symbolize, one frame per line
+  std::string to_string() const;
+
+private:
+  std::array<void*, max_frames> d_frames{};
+  std::size_t                   d_size{0};
+};
+
+std::ostream& operator<<(std::ostream& os, const backtrace& bt);
+
+// Process-wide sampling policy used by backtrace::capture(): 0 disables capturing (the default), 1 captures on every
+// call, n captures on one in every n calls per thread.
+void set_backtrace_sampling(unsigned every_n) noexcept;
+
+unsigned backtrace_sampling() noexcept;
+
+constexpr bool backtrace::empty() const noexcept
+{
+  return d_size == 0;
+}
+
+constexpr std::size_t backtrace::size() const noexcept
+{
+  return d_size;
+}
+
+constexpr void* backtrace::operator[](std::size_t idx) const noexcept
+{
+  return d_frames[idx];
+}
+
+constexpr void* const* backtrace::begin() const noexcept
+{
+  return d_frames.data();
+}
+
+constexpr void* const* backtrace::end() const noexcept
+{
+  return d_frames.data() + d_size;
+}
+
+} // namespace results
@@ -0,0 +1,368 @@
+#pragma once
+
+#include "option.hh"
+#include "result.hh"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <optional>
+
+namespace results {
+
+namespace internal {
+
+constexpr std::size_t cache_line_size = 64;
+
+// block while word == old (futex on linux, yielding elsewhere); may wake spuriously
+void wait_on(const std::atomic<std::uint32_t>& word, std::uint32_t old) noexcept;
+
+void wake_all(std::atomic<std::uint32_t>& word) noexcept;
+
+} // namespace internal
+
+// Bounded lock-free multi-producer multi-consumer queue of result<T, E>. Errors travel as values like any other
+// element. close(e) stops producers; once the remaining elements are drained consumers receive err(e) from then on.
+// Blocking operations spin briefly and then sleep on a futex.
+template <typename T, typename E = error>
+class channel
+{
+public:
+  using value_type = result<T, E>;
+
+  // capacity is rounded up to a power of two
+  explicit channel(std::size_t capacity);
+
+  channel(const channel&) = delete;
+  channel& operator=(const channel&) = delete;
+
+  // info
+  std::size_t capacity() const noexcept;
+
+  bool is_closed() const noexcept;
+
+  // produce: value is only moved from on success. Fails when full or closed, or, for the blocking push(), when closed
+  bool try_push(value_type&& value);
+
+  bool push(value_type&& value);
+
+  // move a prefix of [first, last) in, claiming all slots at once; returns the end of what was pushed
+  template <typename It>
+  It try_push_batch(It first, It last);
+
+  // consume: none when empty, err(e) once closed with e and drained
+  option<value_type> try_pop();
+
+  value_type pop();
+
+  // move up to max elements out; writes the terminal err once closed and drained. Returns the end of the output
+  template <typename OutIt>
+  OutIt try_pop_batch(OutIt out, std::size_t max);
+
+  // close with a terminal error, returns false if already closed
+  bool close(E e);
+
+private:
+  static constexpr std::uint64_t closed_bit = std::uint64_t(1) << 63;
+  static constexpr int           spin_count = 64;
+
+  struct slot
+  {
+    std::atomic<std::uint64_t> seq;
+    std::optional<value_type>  value;
+  };
+
+  // bumped on progress so sleepers can detect it; only wakes when someone announced going to sleep
+  struct alignas(internal::cache_line_size) event
+  {
+    std::atomic<std::uint32_t> counter{0};
+    std::atomic<bool>          sleeping{false};
+  };
+
+  std::optional<value_type> pop_one();
+
+  value_type take(slot& s, std::uint64_t pos);
+
+  std::optional<value_type> terminal(std::uint64_t pos) const;
+
+  void notify(event& ev);
+
+  // retry attempt() until it returns a value, sleeping on ev between attempts
+  template <typename F>
+  auto wait_for(event& ev, F&& attempt) -> typename decltype(attempt())::value_type;
+
+  std::unique_ptr<slot[]> d_slots;
+  std::uint64_t           d_mask;
+  std::optional<E>        d_close_error;
+  std::atomic<int>        d_closing{0};
+
+  alignas(internal::cache_line_size) std::atomic<std::uint64_t> d_enqueue_pos{0};
+  alignas(internal::cache_line_size) std::atomic<std::uint64_t> d_dequeue_pos{0};
+
+  event d_readable;
+  event d_writable;
+};
+
+template <typename T, typename E>
+channel<T, E>::channel(std::size_t capacity)
+{
+  std::size_t size = 1;
+  while(size < capacity)
+  {
+    size <<= 1;
+  }
+  d_slots = std::make_unique<slot[]>(size);
+  d_mask  = size - 1;
+  for(std::size_t i = 0; i < size; ++i)
+  {
+    d_slots[i].seq.store(i, std::memory_order_relaxed);
+  }
+}
+
+template <typename T, typename E>
+std::size_t channel<T, E>::capacity() const noexcept
+{
+  return d_mask + 1;
+}
+
+template <typename T, typename E>
+bool channel<T, E>::is_closed() const noexcept
+{
+  return (d_enqueue_pos.load(std::memory_order_acquire) & closed_bit) != 0;
+}
+
+template <typename T, typename E>
+bool channel<T, E>::try_push(value_type&& value)
+{
+  return try_push_batch(std::addressof(value), std::addressof(value) + 1) != std::addressof(value);
+}
+
+template <typename T, typename E>
+bool channel<T, E>::push(value_type&& value)
+{
+  return wait_for(d_writable, [&]() -> std::optional<bool> {
+    if(try_push(std::move(value)))
+    {
+      return true;
+    }
+    return is_closed() ? std::optional<bool>(false) : std::nullopt;
+  });
+}
+
+template <typename T, typename E>
+template <typename It>
+It channel<T, E>::try_push_batch(It first, It last)
+{
+  auto wanted = static_cast<std::uint64_t>(std::distance(first, last));
+  if(wanted > capacity())
+  {
+    wanted = capacity();
+  }
+
+  auto          pos   = d_enqueue_pos.load(std::memory_order_relaxed);
+  std::uint64_t count = 0;
+  while(wanted > 0)
+  {
+    if(pos & closed_bit)
+    {
+      return first;
+    }
+
+    count = 0;
+    while(count < wanted && d_slots[(pos + count) & d_mask].seq.load(std::memory_order_acquire) == pos + count)
+    {
+      ++count;
+    }
+
+    if(count == 0)
+    {
+      auto seq = d_slots[pos & d_mask].seq.load(std::memory_order_acquire);
+      if(static_cast<std::int64_t>(seq - pos) < 0)
+      {
+        return first; // full
+      }
+      pos = d_enqueue_pos.load(std::memory_order_relaxed);
+    }
+    else if(d_enqueue_pos.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed))
+    {
+      break;
+    }
+  }
+
+  for(std::uint64_t i = 0; i < count; ++i, ++first)
+  {
+    auto& s = d_slots[(pos + i) & d_mask];
+    s.value.emplace(std::move(*first));
+    s.seq.store(pos + i + 1, std::memory_order_release);
+  }
+  if(count > 0)
+  {
+    notify(d_readable);
+  }
+  return first;
+}
+
+template <typename T, typename E>
+option<typename channel<T, E>::value_type> channel<T, E>::try_pop()
+{
+  auto value = pop_one();
+  return value ? make_some<value_type>(std::move(*value)) : make_none<value_type>();
+}
+
+template <typename T, typename E>
+std::optional<typename channel<T, E>::value_type> channel<T, E>::pop_one()
+{
+  auto pos = d_dequeue_pos.load(std::memory_order_relaxed);
+  for(;;)
+  {
+    auto& s    = d_slots[pos & d_mask];
+    auto  seq  = s.seq.load(std::memory_order_acquire);
+    auto  diff = static_cast<std::int64_t>(seq - (pos + 1));
+    if(diff == 0)
+    {
+      if(d_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+      {
+        auto value = take(s, pos);
+        notify(d_writable);
+        return value;
+      }
+    }
+    else if(diff < 0)
+    {
+      return terminal(pos);
+    }
+    else
+    {
+      pos = d_dequeue_pos.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+template <typename T, typename E>
+typename channel<T, E>::value_type channel<T, E>::pop()
+{
+  return wait_for(d_readable, [&] { return pop_one(); });
+}
+
+template <typename T, typename E>
+template <typename OutIt>
+OutIt channel<T, E>::try_pop_batch(OutIt out, std::size_t max)
+{
+  auto wanted = static_cast<std::uint64_t>(max);
+  if(wanted > capacity())
+  {
+    wanted = capacity();
+  }
+
+  auto          pos   = d_dequeue_pos.load(std::memory_order_relaxed);
+  std::uint64_t count = 0;
+  while(wanted > 0)
+  {
+    count = 0;
+    while(count < wanted && d_slots[(pos + count) & d_mask].seq.load(std::memory_order_acquire) == pos + count + 1)
+    {
+      ++count;
+    }
+
+    if(count == 0)
+    {
+      auto seq = d_slots[pos & d_mask].seq.load(std::memory_order_acquire);
+      if(static_cast<std::int64_t>(seq - (pos + 1)) < 0)
+      {
+        if(auto value = terminal(pos))
+        {
+          *out++ = std::move(*value);
+        }
+        return out;
+      }
+      pos = d_dequeue_pos.load(std::memory_order_relaxed);
+    }
+    else if(d_dequeue_pos.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed))
+    {
+      break;
+    }
+  }
+
+  for(std::uint64_t i = 0; i < count; ++i)
+  {
+    *out++ = take(d_slots[(pos + i) & d_mask], pos + i);
+  }
+  if(count > 0)
+  {
+    notify(d_writable);
+  }
+  return out;
+}
+
+template <typename T, typename E>
+bool channel<T, E>::close(E e)
+{
+  int expected = 0;
+  if(!d_closing.compare_exchange_strong(expected, 1, std::memory_order_relaxed))
+  {
+    return false;
+  }
+
+  // the error is published by the release on the closed bit
+  d_close_error.emplace(std::move(e));
+  d_enqueue_pos.fetch_or(closed_bit, std::memory_order_acq_rel);
+
+  notify(d_readable);
+  notify(d_writable);
+  return true;
+}
+
+template <typename T, typename E>
+typename channel<T, E>::value_type channel<T, E>::take(slot& s, std::uint64_t pos)
+{
+  value_type value = std::move(*s.value);
+  s.value.reset();
+  s.seq.store(pos + d_mask + 1, std::memory_order_release);
+  return value;
+}
+
+template <typename T, typename E>
+std::optional<typename channel<T, E>::value_type> channel<T, E>::terminal(std::uint64_t pos) const
+{
+  // drained only once every claimed slot has been consumed, claims in flight still get delivered
+  auto enqueue_pos = d_enqueue_pos.load(std::memory_order_acquire);
+  if((enqueue_pos & closed_bit) && (enqueue_pos & ~closed_bit) == pos)
+  {
+    return value_type::err(*d_close_error);
+  }
+  return std::nullopt;
+}
+
+template <typename T, typename E>
+void channel<T, E>::notify(event& ev)
+{
+  ev.counter.fetch_add(1, std::memory_order_seq_cst);
+  if(ev.sleeping.load(std::memory_order_seq_cst) && ev.sleeping.exchange(false, std::memory_order_seq_cst))
+  {
+    internal::wake_all(ev.counter);
+  }
+}
+
+template <typename T, typename E>
+template <typename F>
+auto channel<T, E>::wait_for(event& ev, F&& attempt) -> typename decltype(attempt())::value_type
+{
+  for(int spin = 0;; ++spin)
+  {
+    auto observed = ev.counter.load(std::memory_order_seq_cst);
+    auto outcome  = attempt();
+    if(outcome)
+    {
+      return std::move(*outcome);
+    }
+    if(spin >= spin_count)
+    {
+      // a notify after this store either sees it and wakes us, or changed the counter before the futex compares it
+      ev.sleeping.store(true, std::memory_order_seq_cst);
+      internal::wait_on(ev.counter, observed);
+    }
+  }
+}
+
+} // namespace results
@@ -0,0 +1,385 @@
+#pragma once
+
+#include "result.hh"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+namespace results {
+
+// the error of a call that a circuit_breaker rejected without making it
+struct circuit_open
+{
+};
+
+constexpr bool operator==(circuit_open, circuit_open) noexcept
+{
+  return true;
+}
+
+constexpr bool operator!=(circuit_open, circuit_open) noexcept
+{
+  return false;
+}
+
+enum class breaker_state : std::uint8_t {
+  closed,    // calls go through, outcomes are counted
+  open,      // calls are rejected until open_duration passed
+  half_open, // a few probe calls go through, the first outcome decides
+};
+
+struct breaker_policy
+{
+  double                   failure_threshold = 0.5; // fraction of failed calls in the window that opens the breaker
+  std::size_t              minimum_calls     = 20;  // fewer calls in the window never open it
+  std::chrono::nanoseconds window            = std::chrono::seconds(10);
+  std::chrono::nanoseconds open_duration     = std::chrono::seconds(5);
+  std::size_t              half_open_probes  = 1; // calls let through at a time while half open
+};
+
+struct breaker_stats
+{
+  std::uint64_t rejected = 0;
+  std::uint64_t trips    = 0; // transitions to open
+};
+
+namespace internal {
+
+// R with circuit_open added to its error types
+template <typename R>
+using breaker_result_t = typename rebind_result<typename R::value_type,
+                                                typename append_unique<typename R::error_types, circuit_open>::type>::type;
+
+} // namespace internal
+
+// Wraps calls returning result<T, E> and fails fast while the callee is failing. Outcomes are counted in a sliding
+// window of time buckets; once at least minimum_calls were made in the window and failure_threshold of them failed,
+// the breaker opens and rejects calls with circuit_open (or an error of the caller's choosing) without making them.
+// After open_duration it lets half_open_probes calls through: a success closes it with a clean window, a failure
+// opens it again. A call that throws counts as failed.
+//
+// Deciding whether a call may go through is a single relaxed load while closed; counting its outcome is one atomic
+// add on the current bucket. Outcomes racing a bucket turning over may be lost, the window is approximate. Clock
+// defaults to the steady clock and can be replaced in tests.
+template <typename Clock = std::chrono::steady_clock>
+class circuit_breaker
+{
+public:
+  explicit circuit_breaker(const breaker_policy& policy = {});
+
+  circuit_breaker(const circuit_breaker&) = delete;
+  circuit_breaker& operator=(const circuit_breaker&) = delete;
+
+  // f() returns result<T, E>, rejected calls return circuit_open
+  template <typename F>
+  auto run(F&& f) -> internal::breaker_result_t<std::invoke_result_t<F&>>;
+
+  // rejected calls return on_open() as their error
+  template <typename F, typename G>
+  auto run(F&& f, G&& on_open) -> std::invoke_result_t<F&>;
+
+  breaker_state state() const noexcept;
+
+  breaker_stats stats() const noexcept;
+
+  const breaker_policy& policy() const noexcept;
+
+  // close the breaker and forget the window
+  void reset() noexcept;
+
+private:
+  static constexpr std::size_t   buckets = 10;
+  static constexpr std::uint64_t unused  = std::numeric_limits<std::uint64_t>::max();
+
+  enum class admission {
+    closed,
+    probe,
+    rejected,
+  };
+
+  // calls made and failed during one bucket's slice of the window
+  struct alignas(64) bucket
+  {
+    std::atomic<std::uint64_t> epoch{unused}; // now / bucket_width of the slice counted
+    std::atomic<std::uint64_t> counts{0};     // failed << 32 | calls
+  };
+
+  // make the call unless rejected, U is the result the caller gets
+  template <typename U, typename F, typename G>
+  U call(F& f, G& on_rejected);
+
+  admission admit() noexcept;
+
+  admission admit_slow(std::uint64_t word) noexcept;
+
+  void complete(admission a, bool ok) noexcept;
+
+  void trip(breaker_state from, std::uint64_t now) noexcept;
+
+  bool should_trip(std::uint64_t now) const noexcept;
+
+  void clear_window() noexcept;
+
+  static std::uint64_t now_ns() noexcept;
+
+  // the state word: the breaker_state in the low two bits, the time it last opened above them, so that opening the
+  // breaker and stamping it is one compare and swap
+  static constexpr std::uint64_t pack(breaker_state s, std::uint64_t opened_at) noexcept;
+
+  static constexpr breaker_state state_of(std::uint64_t word) noexcept;
+
+  static constexpr std::uint64_t opened_at_of(std::uint64_t word) noexcept;
+
+  breaker_policy              d_policy;
+  std::uint64_t               d_bucket_width;
+  std::atomic<std::uint64_t>  d_state{pack(breaker_state::closed, 0)};
+  std::atomic<std::size_t>    d_probes{0};
+  std::atomic<std::uint64_t>  d_rejected{0};
+  std::atomic<std::uint64_t>  d_trips{0};
+  std::array<bucket, buckets> d_window;
+};
+
+template <typename Clock>
+circuit_breaker<Clock>::circuit_breaker(const breaker_policy& policy)
+  : d_policy(policy)
+  , d_bucket_width(std::max<std::uint64_t>(static_cast<std::uint64_t>(policy.window.count()) / buckets, 1))
+{
+}
+
+template <typename Clock>
+template <typename F>
+auto circuit_breaker<Clock>::run(F&& f) -> internal::breaker_result_t<std::invoke_result_t<F&>>
+{
+  using U = internal::breaker_result_t<std::invoke_result_t<F&>>;
+
+  auto rejected = [] { return U::err(circuit_open{}); };
+  return call<U>(f, rejected);
+}
+
+template <typename Clock>
+template <typename F, typename G>
+auto circuit_breaker<Clock>::run(F&& f, G&& on_open) -> std::invoke_result_t<F&>
+{
+  using R = std::invoke_result_t<F&>;
+
+  auto rejected = [&] { return R::err(on_open()); };
+  return call<R>(f, rejected);
+}
+
+template <typename Clock>
+template <typename U, typename F, typename G>
+U circuit_breaker<Clock>::call(F& f, G& on_rejected)
+{
+  using R = std::invoke_result_t<F&>;
+  static_assert(internal::is_result_v<R>, "f() must return a result");
+
+  auto a = admit();
+  if(a == admission::rejected)
+  {
+    return on_rejected();
+  }
+
+  try
+  {
+    R r = f();
+    complete(a, r.is_ok());
+    return U(std::move(r));
+  }
+  catch(...)
+  {
+    complete(a, false);
+    throw;
+  }
+}
+
+template <typename Clock>
+breaker_state circuit_breaker<Clock>::state() const noexcept
+{
+  return state_of(d_state.load(std::memory_order_relaxed));
+}
+
+template <typename Clock>
+breaker_stats circuit_breaker<Clock>::stats() const noexcept
+{
+  return breaker_stats{d_rejected.load(std::memory_order_relaxed), d_trips.load(std::memory_order_relaxed)};
+}
+
+template <typename Clock>
+const breaker_policy& circuit_breaker<Clock>::policy() const noexcept
+{
+  return d_policy;
+}
+
+template <typename Clock>
+void circuit_breaker<Clock>::reset() noexcept
+{
+  clear_window();
+  d_probes.store(0, std::memory_order_relaxed);
+  d_state.store(pack(breaker_state::closed, 0), std::memory_order_release);
+}
+
+template <typename Clock>
+auto circuit_breaker<Clock>::admit() noexcept -> admission
+{
+  auto word = d_state.load(std::memory_order_relaxed);
+  if(state_of(word) == breaker_state::closed)
+  {
+    return admission::closed;
+  }
+  return admit_slow(word);
+}
+
+template <typename Clock>
+auto circuit_breaker<Clock>::admit_slow(std::uint64_t word) noexcept -> admission
+{
+  std::atomic_thread_fence(std::memory_order_acquire);
+  for(;;)
+  {
+    switch(state_of(word))
+    {
+    case breaker_state::closed:
+      return admission::closed;
+
+    case breaker_state::open:
+      if(now_ns() < opened_at_of(word) + static_cast<std::uint64_t>(d_policy.open_duration.count()))
+      {
+        d_rejected.fetch_add(1, std::memory_order_relaxed);
+        return admission::rejected;
+      }
+      // time to probe; the thread moving to half open competes for a probe like everyone else
+      {
+        const auto half_open = pack(breaker_state::half_open, opened_at_of(word));
+        if(d_state.compare_exchange_strong(word, half_open, std::memory_order_acq_rel))
+        {
+          word = half_open;
+        }
+      }
+      break;
+
+    case breaker_state::half_open:
+      if(d_probes.fetch_add(1, std::memory_order_acq_rel) < d_policy.half_open_probes)
+      {
+        return admission::probe;
+      }
+      d_probes.fetch_sub(1, std::memory_order_relaxed);
+      d_rejected.fetch_add(1, std::memory_order_relaxed);
+      return admission::rejected;
+    }
+  }
+}
+
+template <typename Clock>
+void circuit_breaker<Clock>::complete(admission a, bool ok) noexcept
+{
+  const auto now = now_ns();
+  if(a == admission::probe)
+  {
+    d_probes.fetch_sub(1, std::memory_order_relaxed);
+    if(ok)
+    {
+      auto word = d_state.load(std::memory_order_relaxed);
+      if(state_of(word) == breaker_state::half_open &&
+         d_state.compare_exchange_strong(word, pack(breaker_state::closed, opened_at_of(word)), std::memory_order_acq_rel))
+      {
+        clear_window();
+      }
+    }
+    else
+    {
+      trip(breaker_state::half_open, now);
+    }
+    return;
+  }
+
+  auto& b     = d_window[(now / d_bucket_width) % buckets];
+  auto  epoch = b.epoch.load(std::memory_order_relaxed);
+  if(epoch != now / d_bucket_width && (epoch == unused || epoch < now / d_bucket_width) &&
+     b.epoch.compare_exchange_strong(epoch, now / d_bucket_width, std::memory_order_relaxed))
+  {
+    // the bucket turned over, outcomes other threads add until here are lost
+    b.counts.store(0, std::memory_order_relaxed);
+  }
+  b.counts.fetch_add(ok ? 1 : (std::uint64_t(1) << 32 | 1), std::memory_order_relaxed);
+
+  if(!ok && should_trip(now))
+  {
+    trip(breaker_state::closed, now);
+  }
+}
+
+template <typename Clock>
+void circuit_breaker<Clock>::trip(breaker_state from, std::uint64_t now) noexcept
+{
+  // a call that fails once another one tripped the breaker must not move opened_at
+  auto word = d_state.load(std::memory_order_relaxed);
+  while(state_of(word) == from)
+  {
+    if(d_state.compare_exchange_weak(word, pack(breaker_state::open, now), std::memory_order_acq_rel))
+    {
+      d_trips.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+  }
+}
+
+template <typename Clock>
+bool circuit_breaker<Clock>::should_trip(std::uint64_t now) const noexcept
+{
+  const auto    current = now / d_bucket_width;
+  std::uint64_t calls   = 0;
+  std::uint64_t failed  = 0;
+  for(const auto& b : d_window)
+  {
+    auto epoch = b.epoch.load(std::memory_order_relaxed);
+    if(epoch != unused && epoch <= current && current - epoch < buckets)
+    {
+      auto counts = b.counts.load(std::memory_order_relaxed);
+      calls += counts & 0xffffffff;
+      failed += counts >> 32;
+    }
+  }
+  return calls >= d_policy.minimum_calls && calls > 0 &&
+         static_cast<double>(failed) >= d_policy.failure_threshold * static_cast<double>(calls);
+}
+
+template <typename Clock>
+void circuit_breaker<Clock>::clear_window() noexcept
+{
+  for(auto& b : d_window)
+  {
+    b.epoch.store(unused, std::memory_order_relaxed);
+  }
+}
+
+template <typename Clock>
+std::uint64_t circuit_breaker<Clock>::now_ns() noexcept
+{
+  return static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count());
+}
+
+template <typename Clock>
+constexpr std::uint64_t circuit_breaker<Clock>::pack(breaker_state s, std::uint64_t opened_at) noexcept
+{
+  return opened_at << 2 | static_cast<std::uint64_t>(s);
+}
+
+template <typename Clock>
+constexpr breaker_state circuit_breaker<Clock>::state_of(std::uint64_t word) noexcept
+{
+  return static_cast<breaker_state>(word & 3);
+}
+
+template <typename Clock>
+constexpr std::uint64_t circuit_breaker<Clock>::opened_at_of(std::uint64_t word) noexcept
+{
+  return word >> 2;
+}
+
+} // namespace results
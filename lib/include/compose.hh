@@ -0,0 +1,130 @@
+#pragma once
+
+#include "option.hh"
+#include "result.hh"
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+// Free functions combining several results and options. Rvalue arguments are moved from, lvalues are copied; values
+// are constructed in place in the returned object.
+
+namespace results {
+
+namespace internal {
+
+template <typename T>
+constexpr bool is_option_v = false;
+
+template <typename T>
+constexpr bool is_option_v<option<T>> = true;
+
+template <typename List, typename Errors>
+struct append_list;
+
+template <typename List, typename... Xs>
+struct append_list<List, type_list<Xs...>> : append_unique<List, Xs...>
+{
+};
+
+template <typename List, typename... Rs>
+struct zip_errors
+{
+  using type = List;
+};
+
+template <typename List, typename R, typename... Rs>
+struct zip_errors<List, R, Rs...> : zip_errors<typename append_list<List, typename R::error_types>::type, Rs...>
+{
+};
+
+template <typename... Rs>
+using zip_t = typename rebind_result<std::tuple<typename Rs::value_type...>, typename zip_errors<type_list<>, Rs...>::type>::type;
+
+// the error held by the variant of a result, as a result of type R whose error types include it; passing an error on
+// does not count as producing it
+template <typename R, typename V>
+constexpr R convert_err(V&& v)
+{
+  return visit_index<R, 1, std::variant_size_v<std::decay_t<V>>>(v.index(), [&](auto i) {
+    return result_access::err<R>(std::get<i>(std::forward<V>(v)));
+  });
+}
+
+template <typename R, typename First, typename... Rest>
+constexpr R first_err(First&& first, Rest&&... rest)
+{
+  if constexpr(sizeof...(Rest) == 0)
+  {
+    return convert_err<R>(std::forward<First>(first).as_variant());
+  }
+  else
+  {
+    if(first.is_err())
+    {
+      return convert_err<R>(std::forward<First>(first).as_variant());
+    }
+    return first_err<R>(std::forward<Rest>(rest)...);
+  }
+}
+
+} // namespace internal
+
+// ok(tuple of the values) if every argument is ok, the first error otherwise. The error types of the result are the
+// union of those of the arguments.
+template <typename... Rs, typename = std::enable_if_t<(sizeof...(Rs) > 0) && (internal::is_result_v<std::decay_t<Rs>> && ...)>>
+constexpr auto zip(Rs&&... rs) -> internal::zip_t<std::decay_t<Rs>...>
+{
+  using R = internal::zip_t<std::decay_t<Rs>...>;
+
+  if((rs.is_ok() && ...))
+  {
+    return R::ok(std::get<0>(std::forward<Rs>(rs).as_variant())...);
+  }
+  return internal::first_err<R>(std::forward<Rs>(rs)...);
+}
+
+// option<result<T, Es...>> to result<option<T>, Es...>: none becomes ok(none)
+template <typename O, typename = std::enable_if_t<internal::is_option_v<std::decay_t<O>> && internal::is_result_v<typename std::decay_t<O>::value_type>>>
+constexpr auto transpose(O&& o)
+{
+  using inner_type = typename std::decay_t<O>::value_type;
+  using value_type = option<typename inner_type::value_type>;
+  using R          = typename internal::rebind_result<value_type, typename inner_type::error_types>::type;
+
+  if(o.is_none())
+  {
+    return R::ok(value_type::none());
+  }
+
+  auto&& inner = *std::forward<O>(o).as_optional();
+  if(inner.is_ok())
+  {
+    return R::ok(value_type::some(std::get<0>(std::forward<decltype(inner)>(inner).as_variant())));
+  }
+  return internal::convert_err<R>(std::forward<decltype(inner)>(inner).as_variant());
+}
+
+// result<option<T>, Es...> to option<result<T, Es...>>: ok(none) becomes none
+template <typename R, typename = std::enable_if_t<internal::is_result_v<std::decay_t<R>> && internal::is_option_v<typename std::decay_t<R>::value_type>>, typename = void>
+constexpr auto transpose(R&& r)
+{
+  using inner_type = typename std::decay_t<R>::value_type;
+  using value_type = typename internal::rebind_result<typename inner_type::value_type, typename std::decay_t<R>::error_types>::type;
+
+  if(r.is_err())
+  {
+    return option<value_type>::some(internal::convert_err<value_type>(std::forward<R>(r).as_variant()));
+  }
+
+  auto&& inner = std::get<0>(std::forward<R>(r).as_variant());
+  if(inner.is_none())
+  {
+    return option<value_type>::none();
+  }
+  return option<value_type>::some(value_type::ok(*std::forward<decltype(inner)>(inner).as_optional()));
+}
+
+} // namespace results
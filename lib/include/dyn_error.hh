@@ -0,0 +1,234 @@
+#pragma once
+
+#include "result.hh"
+#include <cstddef>
+#include <new>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace results {
+
+class dyn_error;
+
+namespace internal {
+
+// the description dyn_error::message() gives for an error of type X
+template <typename X>
+std::string describe_error(const X& e)
+{
+  if constexpr(has_what_v<X>)
+  {
+    return std::string(e.what());
+  }
+  else if constexpr(has_message_v<X>)
+  {
+    return std::string(e.message());
+  }
+  else if constexpr(has_msg_v<X>)
+  {
+    return std::string(e.msg);
+  }
+  else
+  {
+    return "unknown error";
+  }
+}
+
+} // namespace internal
+
+// Any error type behind one concrete type, for library boundaries that should not spell out every error they pass
+// on. Errors of up to inline_size bytes that move without throwing are stored in place; larger ones are boxed on the
+// heap. downcast<X>() compares a per-type table address instead of going through RTTI, so it costs a single compare.
+// Strings are stored as results::error and exception_ptrs as exception_error, so that make_from_throwable() keeps
+// the exception's message. Move-only errors are accepted too; copying a dyn_error that holds one panics,
+// see is_copyable(). A moved-from dyn_error is empty.
+class dyn_error
+{
+public:
+  static constexpr std::size_t inline_size = 32;
+
+  dyn_error() noexcept;
+
+  template <typename X, typename D = std::decay_t<X>, typename = std::enable_if_t<!std::is_same_v<D, dyn_error>>>
+  dyn_error(X&& e);
+
+  dyn_error(const dyn_error& other);
+  dyn_error(dyn_error&& other) noexcept;
+
+  dyn_error& operator=(const dyn_error& other);
+  dyn_error& operator=(dyn_error&& other) noexcept;
+
+  ~dyn_error();
+
+  // info
+  bool empty() const noexcept;
+
+  template <typename X>
+  bool is() const noexcept;
+
+  // true if the error is stored in place, without an allocation
+  bool is_inline() const noexcept;
+
+  // false if the error is move-only, copies of this dyn_error then panic
+  bool is_copyable() const noexcept;
+
+  // the original error if it is an X, nullptr otherwise; only the exact type matches, not its bases
+  template <typename X>
+  const X* downcast() const noexcept;
+
+  template <typename X>
+  X* downcast() noexcept;
+
+  // what(), message() or msg of the original error, whichever it has
+  std::string message() const;
+
+private:
+  union storage
+  {
+    alignas(std::max_align_t) unsigned char buffer[inline_size];
+    void* boxed;
+  };
+
+  // one per stored type, its address is the type id
+  struct vtable
+  {
+    void (*copy)(const storage& from, storage& to); // null for move-only errors
+    void (*move)(storage& from, storage& to) noexcept;
+    void (*destroy)(storage& s) noexcept;
+    void* (*get)(const storage& s) noexcept;
+    std::string (*message)(const void* e);
+    bool stored_inline;
+  };
+
+  template <typename X>
+  static constexpr bool fits_inline_v =
+      sizeof(X) <= inline_size && alignof(X) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<X>;
+
+  template <typename X>
+  static const vtable table_for;
+
+  template <typename X, typename A>
+  void store(A&& e);
+
+  void reset() noexcept;
+
+  const vtable* d_table;
+  storage       d_storage;
+};
+
+// erases the error types of a result: r.map_err(to_dyn_error)
+inline constexpr auto to_dyn_error = [](auto&& e) { return dyn_error(std::forward<decltype(e)>(e)); };
+
+template <typename T>
+using dyn_result = result<T, dyn_error>;
+
+template <typename X>
+const dyn_error::vtable dyn_error::table_for = {
+    []() -> void (*)(const storage&, storage&) {
+      if constexpr(std::is_copy_constructible_v<X>)
+      {
+        return [](const storage& from, storage& to) {
+          if constexpr(fits_inline_v<X>)
+          {
+            ::new(static_cast<void*>(to.buffer)) X(*std::launder(reinterpret_cast<const X*>(from.buffer)));
+          }
+          else
+          {
+            to.boxed = new X(*static_cast<const X*>(from.boxed));
+          }
+        };
+      }
+      else
+      {
+        return nullptr;
+      }
+    }(),
+    [](storage& from, storage& to) noexcept {
+      if constexpr(fits_inline_v<X>)
+      {
+        X* e = std::launder(reinterpret_cast<X*>(from.buffer));
+        ::new(static_cast<void*>(to.buffer)) X(std::move(*e));
+        e->~X();
+      }
+      else
+      {
+        to.boxed = from.boxed;
+      }
+    },
+    [](storage& s) noexcept {
+      if constexpr(fits_inline_v<X>)
+      {
+        std::launder(reinterpret_cast<X*>(s.buffer))->~X();
+      }
+      else
+      {
+        delete static_cast<X*>(s.boxed);
+      }
+    },
+    [](const storage& s) noexcept -> void* {
+      if constexpr(fits_inline_v<X>)
+      {
+        return const_cast<void*>(static_cast<const void*>(std::launder(reinterpret_cast<const X*>(s.buffer))));
+      }
+      else
+      {
+        return s.boxed;
+      }
+    },
+    [](const void* e) { return internal::describe_error(*static_cast<const X*>(e)); },
+    fits_inline_v<X>,
+};
+
+template <typename X, typename D, typename>
+dyn_error::dyn_error(X&& e)
+  : d_table(nullptr)
+{
+  if constexpr(std::is_convertible_v<X&&, std::string_view> && !std::is_same_v<D, error>)
+  {
+    store<error>(std::string_view(e));
+  }
+  else if constexpr(std::is_same_v<D, std::exception_ptr>)
+  {
+    store<exception_error>(std::forward<X>(e));
+  }
+  else
+  {
+    store<D>(std::forward<X>(e));
+  }
+}
+
+template <typename X, typename A>
+void dyn_error::store(A&& e)
+{
+  if constexpr(fits_inline_v<X>)
+  {
+    ::new(static_cast<void*>(d_storage.buffer)) X(std::forward<A>(e));
+  }
+  else
+  {
+    d_storage.boxed = new X(std::forward<A>(e));
+  }
+  d_table = &table_for<X>;
+}
+
+template <typename X>
+bool dyn_error::is() const noexcept
+{
+  return d_table == &table_for<X>;
+}
+
+template <typename X>
+const X* dyn_error::downcast() const noexcept
+{
+  return is<X>() ? static_cast<const X*>(d_table->get(d_storage)) : nullptr;
+}
+
+template <typename X>
+X* dyn_error::downcast() noexcept
+{
+  return is<X>() ? static_cast<X*>(d_table->get(d_storage)) : nullptr;
+}
+
+} // namespace results
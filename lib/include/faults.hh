@@ -0,0 +1,56 @@
+#pragma once
+
+#include "instrument.hh"
+#include "option.hh"
+#include "result.hh"
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+// Deterministic fault injection (RESULTS_FAULTS), to exercise error paths that are cold in testing. Under the current
+// fault_policy, a fraction of the ok() and make_ok() calls of results whose first error type is nothrow default
+// constructible, such as results::error, return that error default constructed instead. inject_err() and
+// inject_none() mark the other places where a result or an option is produced, with an error of the caller's choosing
+// or none. Whether a production fails is a hash of the seed, its call site and how many productions the thread made
+// since the policy was set, so a run with the same seed and the same inputs fails at the same places.
+
+namespace results {
+
+struct fault_policy
+{
+  double        rate = 0; // of productions that fail, 0 to 1
+  std::uint64_t seed = 0;
+};
+
+// applies to all threads from their next production on, and restarts their sequences
+void set_fault_policy(const fault_policy& policy) noexcept;
+
+fault_policy get_fault_policy() noexcept;
+
+// faults injected since the start of the program, by all threads
+std::uint64_t injected_faults() noexcept;
+
+// r, or the error of make_error() when a fault is injected here, for error types ok() cannot fail with e.g.
+//   return inject_err(parse(text), [] { return error("injected"); });
+template <typename R, typename F, typename = std::enable_if_t<internal::is_result_v<std::decay_t<R>>>>
+constexpr std::decay_t<R> inject_err(R&& r, F&& make_error, internal::call_site site = internal::call_site::current())
+{
+  if(internal::inject_fault(site))
+  {
+    return std::decay_t<R>::err(std::forward<F>(make_error)());
+  }
+  return std::forward<R>(r);
+}
+
+// o, or none when a fault is injected here
+template <typename T>
+constexpr option<T> inject_none(option<T> o, internal::call_site site = internal::call_site::current()) noexcept
+{
+  if(internal::inject_fault(site))
+  {
+    return option<T>::none();
+  }
+  return o;
+}
+
+} // namespace results
@@ -0,0 +1,324 @@
+#pragma once
+
+#include "result.hh"
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace results {
+
+namespace internal {
+
+// coroutine frames come from per-thread free lists by size class, so that creating generators in a loop does not go
+// through the global allocator every time
+void* allocate_frame(std::size_t size);
+
+void deallocate_frame(void* ptr, std::size_t size) noexcept;
+
+template <typename E>
+struct stop_with_error
+{
+  E error;
+};
+
+} // namespace internal
+
+// co_yield stop_with(e) ends a result_generator: the consumer receives err(e) as the last element and the coroutine is
+// not resumed again
+template <typename E>
+internal::stop_with_error<std::decay_t<E>> stop_with(E&& e);
+
+// Lazy stream of result<T, E> produced by a coroutine and consumed with range-for. Elements, errors included, are
+// produced one at a time as the consumer advances. Rvalues are yielded without a copy. Exceptions escaping the
+// coroutine are rethrown to the consumer.
+//
+//   result_generator<record> read(std::istream& in) {
+//     for(std::string line; std::getline(in, line);)
+//       co_yield parse_record(line);
+//   }
+template <typename T, typename E = error>
+class result_generator
+{
+public:
+  using value_type = result<T, E>;
+
+  class promise_type;
+  class iterator;
+
+  result_generator(result_generator&& other) noexcept;
+
+  result_generator& operator=(result_generator&& other) noexcept;
+
+  ~result_generator();
+
+  // starts the coroutine, a generator can be iterated once
+  iterator begin();
+
+  std::default_sentinel_t end() const noexcept;
+
+private:
+  using handle_type = std::coroutine_handle<promise_type>;
+
+  explicit result_generator(handle_type handle) noexcept;
+
+  handle_type d_handle;
+};
+
+template <typename T, typename E>
+class result_generator<T, E>::promise_type
+{
+public:
+  result_generator get_return_object() noexcept;
+
+  std::suspend_always initial_suspend() const noexcept;
+
+  std::suspend_always final_suspend() const noexcept;
+
+  std::suspend_always yield_value(value_type&& value) noexcept;
+
+  std::suspend_always yield_value(const value_type& value);
+
+  template <typename F>
+  std::suspend_always yield_value(internal::stop_with_error<F>&& stop);
+
+  void return_void() const noexcept;
+
+  void unhandled_exception() noexcept;
+
+  static void* operator new(std::size_t size);
+
+  static void operator delete(void* ptr, std::size_t size) noexcept;
+
+private:
+  friend class iterator;
+
+  value_type*               d_current = nullptr;
+  std::optional<value_type> d_copy; // backs d_current when an lvalue or the terminal error was yielded
+  std::exception_ptr        d_exception;
+  bool                      d_stopped = false;
+};
+
+template <typename T, typename E>
+class result_generator<T, E>::iterator
+{
+public:
+  using iterator_category = std::input_iterator_tag;
+  using difference_type   = std::ptrdiff_t;
+  using value_type        = result<T, E>;
+  using reference         = value_type&;
+  using pointer           = value_type*;
+
+  iterator() noexcept = default;
+
+  // the element may be moved from
+  reference operator*() const noexcept;
+
+  pointer operator->() const noexcept;
+
+  iterator& operator++();
+
+  void operator++(int);
+
+  friend bool operator==(const iterator& it, std::default_sentinel_t) noexcept
+  {
+    return !it.d_handle;
+  }
+
+private:
+  friend class result_generator;
+
+  explicit iterator(handle_type handle);
+
+  // resume until the next element; drops the handle once the stream has ended
+  void advance();
+
+  handle_type d_handle;
+};
+
+template <typename E>
+internal::stop_with_error<std::decay_t<E>> stop_with(E&& e)
+{
+  return {std::forward<E>(e)};
+}
+
+template <typename T, typename E>
+result_generator<T, E>::result_generator(handle_type handle) noexcept
+  : d_handle(handle)
+{
+}
+
+template <typename T, typename E>
+result_generator<T, E>::result_generator(result_generator&& other) noexcept
+  : d_handle(std::exchange(other.d_handle, nullptr))
+{
+}
+
+template <typename T, typename E>
+result_generator<T, E>& result_generator<T, E>::operator=(result_generator&& other) noexcept
+{
+  if(this != &other)
+  {
+    if(d_handle)
+    {
+      d_handle.destroy();
+    }
+    d_handle = std::exchange(other.d_handle, nullptr);
+  }
+  return *this;
+}
+
+template <typename T, typename E>
+result_generator<T, E>::~result_generator()
+{
+  if(d_handle)
+  {
+    d_handle.destroy();
+  }
+}
+
+template <typename T, typename E>
+typename result_generator<T, E>::iterator result_generator<T, E>::begin()
+{
+  return iterator(d_handle);
+}
+
+template <typename T, typename E>
+std::default_sentinel_t result_generator<T, E>::end() const noexcept
+{
+  return std::default_sentinel;
+}
+
+template <typename T, typename E>
+result_generator<T, E> result_generator<T, E>::promise_type::get_return_object() noexcept
+{
+  return result_generator(handle_type::from_promise(*this));
+}
+
+template <typename T, typename E>
+std::suspend_always result_generator<T, E>::promise_type::initial_suspend() const noexcept
+{
+  return {};
+}
+
+template <typename T, typename E>
+std::suspend_always result_generator<T, E>::promise_type::final_suspend() const noexcept
+{
+  return {};
+}
+
+template <typename T, typename E>
+std::suspend_always result_generator<T, E>::promise_type::yield_value(value_type&& value) noexcept
+{
+  // the yielded temporary lives in the coroutine frame until the coroutine is resumed
+  d_current = std::addressof(value);
+  return {};
+}
+
+template <typename T, typename E>
+std::suspend_always result_generator<T, E>::promise_type::yield_value(const value_type& value)
+{
+  d_copy.emplace(value);
+  d_current = std::addressof(*d_copy);
+  return {};
+}
+
+template <typename T, typename E>
+template <typename F>
+std::suspend_always result_generator<T, E>::promise_type::yield_value(internal::stop_with_error<F>&& stop)
+{
+  d_copy.emplace(value_type::err(std::move(stop.error)));
+  d_current = std::addressof(*d_copy);
+  d_stopped = true;
+  return {};
+}
+
+template <typename T, typename E>
+void result_generator<T, E>::promise_type::return_void() const noexcept
+{
+}
+
+template <typename T, typename E>
+void result_generator<T, E>::promise_type::unhandled_exception() noexcept
+{
+  d_exception = std::current_exception();
+}
+
+template <typename T, typename E>
+void* result_generator<T, E>::promise_type::operator new(std::size_t size)
+{
+  return internal::allocate_frame(size);
+}
+
+template <typename T, typename E>
+void result_generator<T, E>::promise_type::operator delete(void* ptr, std::size_t size) noexcept
+{
+  internal::deallocate_frame(ptr, size);
+}
+
+template <typename T, typename E>
+result_generator<T, E>::iterator::iterator(handle_type handle)
+  : d_handle(handle)
+{
+  advance();
+}
+
+template <typename T, typename E>
+auto result_generator<T, E>::iterator::operator*() const noexcept -> reference
+{
+  return *d_handle.promise().d_current;
+}
+
+template <typename T, typename E>
+auto result_generator<T, E>::iterator::operator->() const noexcept -> pointer
+{
+  return d_handle.promise().d_current;
+}
+
+template <typename T, typename E>
+auto result_generator<T, E>::iterator::operator++() -> iterator&
+{
+  advance();
+  return *this;
+}
+
+template <typename T, typename E>
+void result_generator<T, E>::iterator::operator++(int)
+{
+  advance();
+}
+
+template <typename T, typename E>
+void result_generator<T, E>::iterator::advance()
+{
+  if(!d_handle)
+  {
+    return;
+  }
+
+  auto& promise = d_handle.promise();
+  if(promise.d_stopped || d_handle.done())
+  {
+    d_handle = nullptr;
+    return;
+  }
+
+  promise.d_current = nullptr;
+  promise.d_copy.reset();
+  d_handle.resume();
+
+  if(d_handle.done())
+  {
+    d_handle = nullptr;
+    if(promise.d_exception)
+    {
+      std::rethrow_exception(std::exchange(promise.d_exception, nullptr));
+    }
+  }
+}
+
+} // namespace results
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstdint>
+#include <source_location>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// Call site instrumentation (RESULTS_INSTRUMENT): ok(), err(), make_ok(), make_err() and expect() count every call per
+// source location in per-thread counters, and panics are counted per location and message. The source location
+// parameters those functions take are empty structs unless a facility that needs them is enabled.
+
+namespace results {
+
+enum class site_kind : std::uint8_t {
+  ok,
+  err,
+  expect,
+};
+
+// file and function refer to static strings of the program
+struct site_count
+{
+  std::string_view    file;
+  std::string_view    function;
+  std::uint_least32_t line;
+  std::uint_least32_t column;
+  site_kind           kind;
+  std::uint64_t       count;
+};
+
+struct panic_count
+{
+  std::string_view    file;
+  std::string_view    function;
+  std::uint_least32_t line;
+  std::uint_least32_t column;
+  std::string         message; // of the most recent panic at this location
+  std::uint64_t       count;
+};
+
+struct instrumentation_snapshot
+{
+  std::vector<site_count>  sites;   // most frequent first
+  std::vector<panic_count> panics;  // most frequent first
+  std::uint64_t            dropped; // calls not attributed because a thread ran out of counter slots
+};
+
+// sums the counters of all threads, including exited ones; empty unless instrumentation is compiled in
+instrumentation_snapshot snapshot_instrumentation();
+
+namespace internal {
+
+#if defined(RESULTS_INSTRUMENT) || defined(RESULTS_RECORD) || defined(RESULTS_FAULTS)
+using call_site = std::source_location;
+#else
+// stands in for std::source_location when instrumentation, the recorder and fault injection are compiled out, callers
+// pass nothing
+struct call_site
+{
+  static constexpr call_site current() noexcept
+  {
+    return {};
+  }
+};
+#endif
+
+// the counters behind record_site() and panic()
+void count_site(site_kind kind, const std::source_location& site) noexcept;
+
+void count_panic(std::string_view msg, const std::source_location& site);
+
+constexpr void record_site(site_kind kind, const call_site& site) noexcept
+{
+#ifdef RESULTS_INSTRUMENT
+  if(!std::is_constant_evaluated())
+  {
+    count_site(kind, site);
+  }
+#else
+  (void)kind;
+  (void)site;
+#endif
+}
+
+// whether to fail a production at site under the fault policy, see faults.hh
+bool should_fault(const std::source_location& site) noexcept;
+
+constexpr bool inject_fault(const call_site& site) noexcept
+{
+#ifdef RESULTS_FAULTS
+  return !std::is_constant_evaluated() && should_fault(site);
+#else
+  (void)site;
+  return false;
+#endif
+}
+
+} // namespace internal
+
+// The caller's location for the multi-argument forms of ok(), err(), make_ok() and make_err(), which cannot take a
+// defaulted location parameter after their arguments, e.g. result<point>::ok(here(), x, y)
+struct at_site
+{
+  internal::call_site site;
+};
+
+constexpr at_site here(internal::call_site site = internal::call_site::current()) noexcept
+{
+  return {site};
+}
+
+} // namespace results
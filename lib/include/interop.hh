@@ -0,0 +1,108 @@
+#pragma once
+
+#include "option.hh"
+#include "result.hh"
+#include <optional>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <version>
+
+#ifdef __cpp_lib_expected
+#include <expected>
+#endif
+
+// Conversions between option/result and their standard library counterparts. Each conversion moves (rvalue argument)
+// or copies (lvalue argument) the payload exactly once and constructs nothing else; for trivially copyable payloads
+// it compiles down to copying the bytes. To only look at an option as a std::optional, use option::as_optional(),
+// which is free.
+
+namespace results {
+
+// std::optional
+template <typename T>
+constexpr option<T> from_optional(const std::optional<T>& o)
+{
+  return o ? option<T>::some(*o) : option<T>::none();
+}
+
+template <typename T>
+constexpr option<T> from_optional(std::optional<T>&& o)
+{
+  return o ? option<T>::some(std::move(*o)) : option<T>::none();
+}
+
+template <typename T>
+constexpr std::optional<T> to_optional(const option<T>& o)
+{
+  return o.as_optional();
+}
+
+template <typename T>
+constexpr std::optional<T> to_optional(option<T>&& o)
+{
+  return std::move(o).as_optional();
+}
+
+// std::error_code: call f(ec) like the non-throwing overloads of std::filesystem, ok unless f set ec. A void f yields
+// an int, like map().
+template <typename F>
+auto make_from_error_code(F&& f) -> result<return_wrapper_t<decltype(f(std::declval<std::error_code&>()))>, std::error_code>
+{
+  using R = return_wrapper<decltype(f(std::declval<std::error_code&>()))>;
+  using U = result<typename R::type, std::error_code>;
+
+  std::error_code ec;
+  auto            value = R::call(f, ec);
+  if(ec)
+  {
+    return U::err(ec);
+  }
+  return U::ok(std::move(value));
+}
+
+// the error of r, or a default constructed (success) error_code, for handing back to error_code based interfaces
+template <typename T>
+constexpr std::error_code to_error_code(const result<T, std::error_code>& r) noexcept
+{
+  return r.is_ok() ? std::error_code() : r.unwrap_err_unchecked();
+}
+
+#ifdef __cpp_lib_expected
+
+// std::expected; results with more than one error type have no std::expected counterpart
+template <typename T, typename E>
+constexpr result<T, E> from_expected(const std::expected<T, E>& e)
+{
+  return e ? result<T, E>::ok(*e) : result<T, E>::err(e.error());
+}
+
+template <typename T, typename E>
+constexpr result<T, E> from_expected(std::expected<T, E>&& e)
+{
+  return e ? result<T, E>::ok(std::move(*e)) : result<T, E>::err(std::move(e).error());
+}
+
+template <typename T, typename E>
+constexpr std::expected<T, E> to_expected(const result<T, E>& r)
+{
+  if(r.is_ok())
+  {
+    return std::expected<T, E>(std::in_place, r.unwrap_unchecked());
+  }
+  return std::expected<T, E>(std::unexpect, r.unwrap_err_unchecked());
+}
+
+template <typename T, typename E>
+constexpr std::expected<T, E> to_expected(result<T, E>&& r)
+{
+  if(r.is_ok())
+  {
+    return std::expected<T, E>(std::in_place, std::get<0>(std::move(r).as_variant()));
+  }
+  return std::expected<T, E>(std::unexpect, std::get<1>(std::move(r).as_variant()));
+}
+
+#endif
+
+} // namespace results
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "generator.hh"
+#include "result.hh"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+namespace results {
+namespace io {
+
+// errno of a failed system call and the name of the call, 16 bytes; the message is only formatted when asked for
+struct sys_error
+{
+  int         code;
+  const char* operation; // a static string
+
+  // e.g. "open: No such file or directory"
+  std::string message() const;
+
+  std::error_code error_code() const noexcept;
+};
+
+bool operator==(const sys_error& lhs, const sys_error& rhs) noexcept;
+
+bool operator!=(const sys_error& lhs, const sys_error& rhs) noexcept;
+
+// the error left in errno by the last failed call
+sys_error last_error(const char* operation) noexcept;
+
+// An open file descriptor, closed on destruction
+class file
+{
+public:
+  // read-only
+  static result<file, sys_error> open(const std::filesystem::path& path);
+
+  file(file&& other) noexcept;
+  file& operator=(file&& other) noexcept;
+
+  ~file();
+
+  int fd() const noexcept;
+
+  result<std::uint64_t, sys_error> size() const;
+
+private:
+  explicit file(int fd) noexcept;
+
+  int d_fd;
+};
+
+// A read-only memory mapping of a whole file, unmapped on destruction. Empty files have an empty view and no mapping.
+class mapped_view
+{
+public:
+  mapped_view() noexcept;
+
+  mapped_view(mapped_view&& other) noexcept;
+  mapped_view& operator=(mapped_view&& other) noexcept;
+
+  ~mapped_view();
+
+  const std::byte* data() const noexcept;
+
+  std::size_t size() const noexcept;
+
+  bool empty() const noexcept;
+
+  std::span<const std::byte> bytes() const noexcept;
+
+  std::string_view text() const noexcept;
+
+private:
+  friend result<mapped_view, sys_error> map_file(const std::filesystem::path& path);
+
+  mapped_view(void* addr, std::size_t size) noexcept;
+
+  void*       d_addr;
+  std::size_t d_size;
+};
+
+// map the file at path, the data is never copied
+result<mapped_view, sys_error> map_file(const std::filesystem::path& path);
+
+// Read into buffer from offset with pread(), until buffer is full or the end of the file; returns the number of bytes
+// read. Interrupted calls are restarted.
+result<std::size_t, sys_error> read_at(int fd, std::span<std::byte> buffer, std::uint64_t offset);
+
+result<std::size_t, sys_error> read_at(const file& f, std::span<std::byte> buffer, std::uint64_t offset);
+
+enum class entry_type {
+  file,
+  directory,
+  symlink,
+  other,
+  unknown,
+};
+
+struct directory_entry
+{
+  std::string name;
+  entry_type  type; // unknown on file systems that do not report it, ask stat() then
+};
+
+// the entries of dir except "." and "..", in the order the file system returns them; failing to open or read the
+// directory ends the stream with an error
+result_generator<directory_entry, sys_error> read_directory(std::filesystem::path dir);
+
+} // namespace io
+} // namespace results
@@ -0,0 +1,220 @@
+#pragma once
+
+#include "option.hh"
+#include "result.hh"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+
+namespace results {
+
+struct memoize_options
+{
+  std::size_t              shards   = 16;
+  std::size_t              capacity = 1024; // entries, across all shards
+  std::chrono::nanoseconds ok_ttl   = std::chrono::minutes(5);
+  std::chrono::nanoseconds err_ttl  = std::chrono::seconds(5);
+};
+
+// Sharded concurrent cache in front of a fallible function K -> result<V, E>. Errors are cached too, with their own
+// time to live, so a failing key is not retried on every call. Concurrent misses on a key share a single call. Each
+// shard evicts its least recently used entry when full. Entries are handed out as shared pointers, never copied.
+template <typename K, typename R, typename Hash = std::hash<K>, typename Clock = std::chrono::steady_clock>
+class memoize
+{
+  static_assert(std::is_same_v<R, result<typename R::value_type, typename R::error_type>>, "memoize caches results");
+
+public:
+  using key_type    = K;
+  using result_type = R;
+  using value_ptr   = std::shared_ptr<const R>;
+
+  template <typename F>
+  explicit memoize(F&& compute, const memoize_options& options = {});
+
+  // the cached result for key, computing it on a miss or after expiry, like option::get_or_insert_with()
+  value_ptr get(const K& key);
+
+  // the cached result for key if it is present and not expired, never computes
+  option<value_ptr> peek(const K& key) const;
+
+  void invalidate(const K& key);
+
+  std::size_t size() const;
+
+private:
+  using time_point = typename Clock::time_point;
+
+  struct entry
+  {
+    std::shared_future<value_ptr>   value;
+    time_point                      expires;
+    std::uint64_t                   generation;
+    typename std::list<K>::iterator lru;
+  };
+
+  struct shard
+  {
+    mutable std::mutex                 mutex;
+    std::unordered_map<K, entry, Hash> entries;
+    std::list<K>                       lru; // most recently used first
+    std::uint64_t                      generation = 0;
+  };
+
+  shard& shard_for(const K& key) const;
+
+  static bool is_live(const entry& e, time_point now) noexcept;
+
+  static void erase(shard& s, typename std::unordered_map<K, entry, Hash>::iterator it);
+
+  std::function<R(const K&)> d_compute;
+  memoize_options            d_options;
+  std::size_t                d_shard_capacity;
+  std::unique_ptr<shard[]>   d_shards;
+};
+
+template <typename K, typename R, typename Hash, typename Clock>
+template <typename F>
+memoize<K, R, Hash, Clock>::memoize(F&& compute, const memoize_options& options)
+  : d_compute(std::forward<F>(compute))
+  , d_options(options)
+{
+  d_options.shards = std::max<std::size_t>(d_options.shards, 1);
+  d_shard_capacity = std::max<std::size_t>((d_options.capacity + d_options.shards - 1) / d_options.shards, 1);
+  d_shards         = std::make_unique<shard[]>(d_options.shards);
+}
+
+template <typename K, typename R, typename Hash, typename Clock>
+auto memoize<K, R, Hash, Clock>::get(const K& key) -> value_ptr
+{
+  auto&                        s = shard_for(key);
+  std::unique_lock<std::mutex> lock(s.mutex);
+
+  auto it = s.entries.find(key);
+  if(it != s.entries.end())
+  {
+    auto& e = it->second;
+    if(is_live(e, Clock::now()))
+    {
+      s.lru.splice(s.lru.begin(), s.lru, e.lru);
+      auto value = e.value;
+      lock.unlock();
+      return value.get(); // waits if another caller is still computing
+    }
+    erase(s, it);
+  }
+
+  while(s.entries.size() >= d_shard_capacity)
+  {
+    erase(s, s.entries.find(s.lru.back()));
+  }
+
+  std::promise<value_ptr> promise;
+  auto                    generation = ++s.generation;
+  s.lru.push_front(key);
+  s.entries.emplace(key, entry{promise.get_future().share(), time_point::max(), generation, s.lru.begin()});
+  lock.unlock();
+
+  // the entry may have been evicted or replaced while computing
+  auto is_ours = [&] { return it != s.entries.end() && it->second.generation == generation; };
+
+  value_ptr value;
+  try
+  {
+    value = std::make_shared<const R>(d_compute(key));
+  }
+  catch(...)
+  {
+    lock.lock();
+    it = s.entries.find(key);
+    if(is_ours())
+    {
+      erase(s, it);
+    }
+    lock.unlock();
+    promise.set_exception(std::current_exception());
+    throw;
+  }
+
+  lock.lock();
+  it = s.entries.find(key);
+  if(is_ours())
+  {
+    auto ttl           = value->is_ok() ? d_options.ok_ttl : d_options.err_ttl;
+    it->second.expires = Clock::now() + std::chrono::duration_cast<typename Clock::duration>(ttl);
+  }
+  lock.unlock();
+  promise.set_value(value);
+  return value;
+}
+
+template <typename K, typename R, typename Hash, typename Clock>
+auto memoize<K, R, Hash, Clock>::peek(const K& key) const -> option<value_ptr>
+{
+  auto&                       s = shard_for(key);
+  std::lock_guard<std::mutex> lock(s.mutex);
+
+  auto it = s.entries.find(key);
+  if(it == s.entries.end() || it->second.expires == time_point::max() || !is_live(it->second, Clock::now()))
+  {
+    return make_none<value_ptr>();
+  }
+  return make_some<value_ptr>(it->second.value.get());
+}
+
+template <typename K, typename R, typename Hash, typename Clock>
+void memoize<K, R, Hash, Clock>::invalidate(const K& key)
+{
+  auto&                       s = shard_for(key);
+  std::lock_guard<std::mutex> lock(s.mutex);
+
+  auto it = s.entries.find(key);
+  if(it != s.entries.end())
+  {
+    erase(s, it);
+  }
+}
+
+template <typename K, typename R, typename Hash, typename Clock>
+std::size_t memoize<K, R, Hash, Clock>::size() const
+{
+  std::size_t total = 0;
+  for(std::size_t i = 0; i < d_options.shards; ++i)
+  {
+    std::lock_guard<std::mutex> lock(d_shards[i].mutex);
+    total += d_shards[i].entries.size();
+  }
+  return total;
+}
+
+template <typename K, typename R, typename Hash, typename Clock>
+auto memoize<K, R, Hash, Clock>::shard_for(const K& key) const -> shard&
+{
+  // the unordered_map of the shard uses the same hash, take the high bits to keep them independent
+  auto h = Hash{}(key) * static_cast<std::size_t>(0x9e3779b97f4a7c15ull);
+  return d_shards[(h >> (sizeof(std::size_t) * 4)) % d_options.shards];
+}
+
+template <typename K, typename R, typename Hash, typename Clock>
+bool memoize<K, R, Hash, Clock>::is_live(const entry& e, time_point now) noexcept
+{
+  // entries still being computed never expire
+  return e.expires == time_point::max() || now < e.expires;
+}
+
+template <typename K, typename R, typename Hash, typename Clock>
+void memoize<K, R, Hash, Clock>::erase(shard& s, typename std::unordered_map<K, entry, Hash>::iterator it)
+{
+  s.lru.erase(it->second.lru);
+  s.entries.erase(it);
+}
+
+} // namespace results
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "utils.hh"
+#include <memory>
 #include <optional>
 #include <string_view>
 #include <type_traits>
@@ -23,17 +24,36 @@ public:
   template <typename... Args>
   static constexpr option<T> some(Args&&... args) noexcept;
 
+  template <typename Alloc, typename... Args>
+  static constexpr option<T> some(std::allocator_arg_t, Alloc&& alloc, Args&&... args) noexcept;
+
   static constexpr option<T> none() noexcept;
 
+  // allocator-extended copy and move, used by allocator-aware containers
+  template <typename Alloc>
+  constexpr option(std::allocator_arg_t, const Alloc& alloc, const option<T>& other);
+
+  template <typename Alloc>
+  constexpr option(std::allocator_arg_t, const Alloc& alloc, option<T>&& other);
+
+  constexpr option(const option<T>&) = default;
+  constexpr option(option<T>&&)      = default;
+
+  option<T>& operator=(const option<T>&) = default;
+  option<T>& operator=(option<T>&&) = default;
+
   // info
   bool constexpr is_none() const noexcept;
 
   bool constexpr is_some() const noexcept;
 
   // raw access
-  constexpr const T& expect(std::string_view msg) const;
+  constexpr const T& expect(std::string_view msg, internal::call_site site = internal::call_site::current()) const;
+
+  constexpr const T& unwrap(internal::call_site site = internal::call_site::current()) const;
 
-  constexpr const T& unwrap() const;
+  // unwrap without checking, the caller guarantees is_some(); verified in debug builds, see RESULTS_VERIFY_UNCHECKED
+  constexpr const T& unwrap_unchecked() const noexcept(!RESULTS_VERIFY_UNCHECKED);
 
   constexpr const T& unwrap_or(const T& other) const noexcept;
 
@@ -81,14 +101,23 @@ public:
   auto map_or_else(F1&& f, const F2& def) const -> decltype(f(unwrap()));
 
   // misc
-  constexpr value_type flatten() const noexcept;
+  constexpr value_type flatten() const& noexcept;
+
+  constexpr value_type flatten() && noexcept;
+
+  // the storage; an rvalue option lets the payload be moved out
+  constexpr const std::optional<T>& as_optional() const& noexcept;
+
+  constexpr std::optional<T>&& as_optional() && noexcept;
 
   template <typename F>
   auto consume(F && f) -> option<return_wrapper_t<decltype(f(value()))>>;
 
 private:
   template <typename... Args>
-  constexpr option(Args&&... args) noexcept;
+  constexpr option(std::in_place_t, Args&&... args) noexcept;
+
+  constexpr option(std::nullopt_t) noexcept;
 
   std::optional<T> d_value;
 };
@@ -112,16 +141,46 @@ constexpr option<T> option<T>::some(Args&&... args) noexcept
   return option<T>(std::in_place, std::forward<Args>(args)...);
 }
 
+template <typename T>
+template <typename Alloc, typename... Args>
+constexpr option<T> option<T>::some(std::allocator_arg_t, Alloc&& alloc, Args&&... args) noexcept
+{
+  return internal::construct_using_allocator<T>(
+      [](auto&&... a) { return option<T>(std::in_place, std::forward<decltype(a)>(a)...); },
+      alloc,
+      std::forward<Args>(args)...);
+}
+
 template <typename T>
 constexpr option<T> option<T>::none() noexcept
 {
   return option<T>(std::nullopt);
 }
 
+template <typename T>
+template <typename Alloc>
+constexpr option<T>::option(std::allocator_arg_t, const Alloc& alloc, const option<T>& other)
+  : option(other.is_some() ? some(std::allocator_arg, alloc, *other.d_value) : none())
+{
+}
+
+template <typename T>
+template <typename Alloc>
+constexpr option<T>::option(std::allocator_arg_t, const Alloc& alloc, option<T>&& other)
+  : option(other.is_some() ? some(std::allocator_arg, alloc, std::move(*other.d_value)) : none())
+{
+}
+
 template <typename T>
 template <typename... Args>
-constexpr option<T>::option(Args&&... args) noexcept
-  : d_value(std::forward<Args>(args)...)
+constexpr option<T>::option(std::in_place_t, Args&&... args) noexcept
+  : d_value(std::in_place, std::forward<Args>(args)...)
+{
+}
+
+template <typename T>
+constexpr option<T>::option(std::nullopt_t) noexcept
+  : d_value(std::nullopt)
 {
 }
 
@@ -138,9 +197,22 @@ constexpr bool option<T>::is_some() const noexcept
 }
 
 template <typename T>
-constexpr const T& option<T>::unwrap() const
+constexpr const T& option<T>::unwrap(internal::call_site site) const
+{
+  return expect("unwrapping none", site);
+}
+
+template <typename T>
+constexpr const T& option<T>::unwrap_unchecked() const noexcept(!RESULTS_VERIFY_UNCHECKED)
 {
-  return expect("unwrapping none");
+#if RESULTS_VERIFY_UNCHECKED
+  internal::assume(is_some(), "unwrapping none unchecked");
+  return *d_value;
+#else
+  // dereferencing the std::optional already carries the precondition, an explicit assume() on the engaged flag
+  // hinders vectorization with gcc
+  return *d_value;
+#endif
 }
 
 template <typename T>
@@ -157,11 +229,12 @@ T option<T>::unwrap_or_else(F&& f) const
 }
 
 template <typename T>
-constexpr const T& option<T>::expect(std::string_view msg) const
+constexpr const T& option<T>::expect(std::string_view msg, internal::call_site site) const
 {
+  internal::record_site(site_kind::expect, site);
   if(!is_some())
   {
-    internal::panic(msg);
+    internal::panic(msg, site);
   }
   return *d_value;
 }
@@ -275,7 +348,7 @@ auto option<T>::map_or_else(F1&& f, const F2& def) const -> decltype(f(unwrap())
 template <typename T>
 constexpr option<T> option<T>::replace(T value) noexcept
 {
-  option<T> other(std::move(value));
+  option<T> other(std::in_place, std::move(value));
   d_value.swap(other.d_value);
   return other;
 }
@@ -283,7 +356,7 @@ constexpr option<T> option<T>::replace(T value) noexcept
 template <typename T>
 constexpr option<T> option<T>::take() noexcept
 {
-  option<T> other;
+  option<T> other(std::nullopt);
   d_value.swap(other.d_value);
   return other;
 }
@@ -316,10 +389,159 @@ auto option<T>::consume(F&& f) -> option<return_wrapper_t<decltype(f(value()))>>
 
 
 template <typename T>
-constexpr typename option<T>::value_type option<T>::flatten() const noexcept
+constexpr typename option<T>::value_type option<T>::flatten() const& noexcept
 {
   static_assert(std::is_same_v<option<typename T::value_type>, T>, "contained type must be an option itself");
-  return is_some() ? unwrap() : make_none<typename T::value_type>();
+  return is_some() ? *d_value : make_none<typename T::value_type>();
+}
+
+template <typename T>
+constexpr typename option<T>::value_type option<T>::flatten() && noexcept
+{
+  static_assert(std::is_same_v<option<typename T::value_type>, T>, "contained type must be an option itself");
+  return is_some() ? std::move(*d_value) : make_none<typename T::value_type>();
+}
+
+template <typename T>
+constexpr const std::optional<T>& option<T>::as_optional() const& noexcept
+{
+  return d_value;
+}
+
+template <typename T>
+constexpr std::optional<T>&& option<T>::as_optional() && noexcept
+{
+  return std::move(d_value);
+}
+
+// comparison: none compares less than any some, like std::optional
+template <typename T>
+constexpr bool operator==(const option<T>& lhs, const option<T>& rhs)
+{
+  return lhs.is_some() == rhs.is_some() && (lhs.is_none() || lhs.unwrap_unchecked() == rhs.unwrap_unchecked());
+}
+
+template <typename T>
+constexpr bool operator!=(const option<T>& lhs, const option<T>& rhs)
+{
+  return !(lhs == rhs);
+}
+
+template <typename T>
+constexpr bool operator<(const option<T>& lhs, const option<T>& rhs)
+{
+  return rhs.is_some() && (lhs.is_none() || lhs.unwrap_unchecked() < rhs.unwrap_unchecked());
+}
+
+template <typename T>
+constexpr bool operator>(const option<T>& lhs, const option<T>& rhs)
+{
+  return rhs < lhs;
+}
+
+template <typename T>
+constexpr bool operator<=(const option<T>& lhs, const option<T>& rhs)
+{
+  return !(rhs < lhs);
+}
+
+template <typename T>
+constexpr bool operator>=(const option<T>& lhs, const option<T>& rhs)
+{
+  return !(lhs < rhs);
+}
+
+// mixed comparison: a bare value compares as some(value)
+template <typename T>
+constexpr bool operator==(const option<T>& lhs, const typename option<T>::value_type& rhs)
+{
+  return lhs.is_some() && lhs.unwrap_unchecked() == rhs;
+}
+
+template <typename T>
+constexpr bool operator==(const typename option<T>::value_type& lhs, const option<T>& rhs)
+{
+  return rhs == lhs;
+}
+
+template <typename T>
+constexpr bool operator!=(const option<T>& lhs, const typename option<T>::value_type& rhs)
+{
+  return !(lhs == rhs);
+}
+
+template <typename T>
+constexpr bool operator!=(const typename option<T>::value_type& lhs, const option<T>& rhs)
+{
+  return !(rhs == lhs);
+}
+
+template <typename T>
+constexpr bool operator<(const option<T>& lhs, const typename option<T>::value_type& rhs)
+{
+  return lhs.is_none() || lhs.unwrap_unchecked() < rhs;
+}
+
+template <typename T>
+constexpr bool operator<(const typename option<T>::value_type& lhs, const option<T>& rhs)
+{
+  return rhs.is_some() && lhs < rhs.unwrap_unchecked();
+}
+
+template <typename T>
+constexpr bool operator>(const option<T>& lhs, const typename option<T>::value_type& rhs)
+{
+  return rhs < lhs;
+}
+
+template <typename T>
+constexpr bool operator>(const typename option<T>::value_type& lhs, const option<T>& rhs)
+{
+  return rhs < lhs;
+}
+
+template <typename T>
+constexpr bool operator<=(const option<T>& lhs, const typename option<T>::value_type& rhs)
+{
+  return !(rhs < lhs);
+}
+
+template <typename T>
+constexpr bool operator<=(const typename option<T>::value_type& lhs, const option<T>& rhs)
+{
+  return !(rhs < lhs);
+}
+
+template <typename T>
+constexpr bool operator>=(const option<T>& lhs, const typename option<T>::value_type& rhs)
+{
+  return !(lhs < rhs);
+}
+
+template <typename T>
+constexpr bool operator>=(const typename option<T>::value_type& lhs, const option<T>& rhs)
+{
+  return !(lhs < rhs);
 }
 
 } // namespace results
+
+namespace std {
+
+template <typename T, typename Alloc>
+struct uses_allocator<results::option<T>, Alloc>
+  : uses_allocator<T, Alloc>
+{
+};
+
+template <typename T>
+  requires results::internal::is_hashable_v<T>
+struct hash<results::option<T>>
+{
+  size_t operator()(const results::option<T>& o) const noexcept
+  {
+    return o.is_some() ? results::internal::hash_with_tag(o.unwrap_unchecked(), 1) : results::internal::hash_with_tag(0, 0);
+  }
+};
+
+} // namespace std
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "result.hh"
+#include <charconv>
+#include <cstddef>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+namespace results {
+
+enum class parse_errc {
+  empty,
+  invalid,
+  out_of_range,
+  trailing_characters,
+};
+
+// compact, allocation-free error: what went wrong and at which offset in the input
+struct parse_error
+{
+  std::size_t position;
+  parse_errc  kind;
+
+  std::string_view message() const noexcept;
+};
+
+constexpr bool operator==(const parse_error& lhs, const parse_error& rhs) noexcept
+{
+  return lhs.position == rhs.position && lhs.kind == rhs.kind;
+}
+
+constexpr bool operator!=(const parse_error& lhs, const parse_error& rhs) noexcept
+{
+  return !(lhs == rhs);
+}
+
+// Specialize to parse enums by name, e.g.
+//   template <> struct enum_names<color> {
+//     static constexpr std::pair<std::string_view, color> values[] = {{"red", color::red}, {"blue", color::blue}};
+//   };
+// Enums without names are parsed as their underlying integer.
+template <typename E>
+struct enum_names;
+
+// Parse the whole of s as a T without allocating or throwing. Supports integers, floating point, bool ("true",
+// "false", "1" or "0") and enums. Like std::from_chars, leading whitespace and '+' are rejected.
+template <typename T>
+result<T, parse_error> parse(std::string_view s) noexcept;
+
+namespace internal {
+
+template <typename E, typename = void>
+struct has_enum_names : std::false_type
+{
+};
+
+template <typename E>
+struct has_enum_names<E, std::void_t<decltype(enum_names<E>::values)>> : std::true_type
+{
+};
+
+template <typename T, typename... Args>
+result<T, parse_error> from_chars(std::string_view s, Args... args) noexcept
+{
+  using R = result<T, parse_error>;
+
+  T value{};
+  auto [ptr, ec] = std::from_chars(s.data(), s.data() + s.size(), value, args...);
+  if(ec == std::errc::invalid_argument)
+  {
+    return R::err(parse_error{0, parse_errc::invalid});
+  }
+  if(ec == std::errc::result_out_of_range)
+  {
+    return R::err(parse_error{0, parse_errc::out_of_range});
+  }
+  if(ptr != s.data() + s.size())
+  {
+    return R::err(parse_error{static_cast<std::size_t>(ptr - s.data()), parse_errc::trailing_characters});
+  }
+  return R::ok(value);
+}
+
+} // namespace internal
+
+template <typename T>
+result<T, parse_error> parse(std::string_view s) noexcept
+{
+  using R = result<T, parse_error>;
+
+  if(s.empty())
+  {
+    return R::err(parse_error{0, parse_errc::empty});
+  }
+
+  if constexpr(std::is_same_v<T, bool>)
+  {
+    if(s == "true" || s == "1")
+    {
+      return R::ok(true);
+    }
+    if(s == "false" || s == "0")
+    {
+      return R::ok(false);
+    }
+    return R::err(parse_error{0, parse_errc::invalid});
+  }
+  else if constexpr(std::is_enum_v<T> && internal::has_enum_names<T>::value)
+  {
+    for(auto&& [name, value] : enum_names<T>::values)
+    {
+      if(s == name)
+      {
+        return R::ok(value);
+      }
+    }
+    return R::err(parse_error{0, parse_errc::invalid});
+  }
+  else if constexpr(std::is_enum_v<T>)
+  {
+    using U = std::underlying_type_t<T>;
+    return internal::from_chars<U>(s).map([](U u) { return static_cast<T>(u); });
+  }
+  else if constexpr(std::is_integral_v<T>)
+  {
+    return internal::from_chars<T>(s, 10);
+  }
+  else
+  {
+    static_assert(std::is_floating_point_v<T>, "parse<T> supports integers, floating point, bool and enums");
+    return internal::from_chars<T>(s, std::chars_format::general);
+  }
+}
+
+} // namespace results
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "option.hh"
+#include "result.hh"
+#include <memory_resource>
+#include <string>
+#include <string_view>
+
+namespace results {
+namespace pmr {
+
+// Like results::error, but the message is allocated from a memory resource so that error traffic can be released
+// with the arena it lives in. Construct with make_err<T, pmr::error>(std::allocator_arg, alloc, msg).
+struct error
+{
+  using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+  std::pmr::string msg;
+#ifdef RESULTS_BACKTRACE
+  // stack at construction, empty unless backtrace sampling is enabled
+  backtrace trace;
+#endif
+  error(std::string_view m = "", const allocator_type& alloc = {}) noexcept;
+
+  explicit error(const allocator_type& alloc) noexcept;
+
+  error(const error& other, const allocator_type& alloc);
+
+  error(error&& other, const allocator_type& alloc);
+
+  error(const error&) = default;
+  error(error&&)      = default;
+
+  error& operator=(const error&) = default;
+  error& operator=(error&&) = default;
+
+  allocator_type get_allocator() const noexcept;
+};
+
+template <typename T, typename E = error>
+using result = results::result<T, E>;
+
+} // namespace pmr
+} // namespace results
@@ -0,0 +1,145 @@
+#pragma once
+
+#include "instrument.hh"
+#include <cstddef>
+#include <cstdint>
+#include <source_location>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// A flight recorder of recent errors (RESULTS_RECORD). Every error created through err(), make_err() or
+// make_from_throwable(), and every panic, leaves a compact record in a per-thread ring buffer that keeps the most
+// recent ones. dump_error_records() merges the buffers of all threads by time, for post-mortem inspection after an
+// incident.
+
+namespace results {
+
+enum class record_kind : std::uint8_t {
+  err,
+  panic,
+};
+
+// file and function refer to static strings of the program, empty when the call site is unknown
+struct error_record
+{
+  static constexpr std::size_t max_message = 72;
+
+  std::uint64_t       timestamp; // nanoseconds on the steady clock
+  std::uint32_t       thread;    // threads are numbered in the order of their first record
+  record_kind         kind;
+  std::string_view    file;
+  std::string_view    function;
+  std::uint_least32_t line;
+  std::uint_least32_t column;
+  std::int64_t        code;    // of integer, enum and std::error_code errors, 0 otherwise
+  std::string         message; // what(), msg or message() of the error, cut at max_message bytes
+};
+
+// the records of all threads, including exited ones, oldest first; empty unless the recorder is compiled in
+std::vector<error_record> dump_error_records();
+
+// leave out everything recorded so far from later dumps
+void clear_error_records();
+
+namespace internal {
+
+template <typename X, typename = void>
+constexpr bool has_what_v = false;
+
+template <typename X>
+constexpr bool has_what_v<X, std::void_t<decltype(std::string_view(std::declval<const X&>().what()))>> = true;
+
+// a string that outlives the call returning it: a pointer, a view or a reference to one the error holds; strings
+// returned by value, of any type, are gone before a view of them could be used
+template <typename R>
+constexpr bool is_string_view_v = std::is_same_v<std::remove_cv_t<R>, const char*> ||
+                                  std::is_same_v<std::remove_cv_t<R>, std::string_view> ||
+                                  (std::is_lvalue_reference_v<R> && std::is_convertible_v<R, std::string_view>);
+
+template <typename X, typename = void>
+constexpr bool has_what_view_v = false;
+
+template <typename X>
+constexpr bool has_what_view_v<X, std::void_t<decltype(std::declval<const X&>().what())>> =
+    is_string_view_v<decltype(std::declval<const X&>().what())>;
+
+template <typename X, typename = void>
+constexpr bool has_message_v = false;
+
+template <typename X>
+constexpr bool has_message_v<X, std::void_t<decltype(std::string(std::declval<const X&>().message()))>> = true;
+
+template <typename X, typename = void>
+constexpr bool has_msg_v = false;
+
+template <typename X>
+constexpr bool has_msg_v<X, std::void_t<decltype(std::string_view(std::declval<const X&>().msg))>> = true;
+
+template <typename X, typename = void>
+constexpr bool has_message_view_v = false;
+
+template <typename X>
+constexpr bool has_message_view_v<X, std::void_t<decltype(std::declval<const X&>().message())>> =
+    is_string_view_v<decltype(std::declval<const X&>().message())>;
+
+// the part of an error that is worth a record and can be had without allocating
+struct error_summary
+{
+  std::int64_t     code = 0;
+  std::string_view message;
+};
+
+template <typename X>
+error_summary summarize_error(const X& e) noexcept
+{
+  if constexpr(std::is_integral_v<X> || std::is_enum_v<X>)
+  {
+    return {static_cast<std::int64_t>(e), {}};
+  }
+  else if constexpr(std::is_same_v<X, std::error_code>)
+  {
+    return {e.value(), e.category().name()};
+  }
+  else if constexpr(has_what_view_v<X>)
+  {
+    return {0, e.what()};
+  }
+  else if constexpr(has_msg_v<X>)
+  {
+    return {0, e.msg};
+  }
+  else if constexpr(has_message_view_v<X>)
+  {
+    return {0, e.message()};
+  }
+  else
+  {
+    return {};
+  }
+}
+
+// appends to the calling thread's ring buffer, for record_err() and panic()
+void record_error(record_kind kind, const std::source_location& site, std::int64_t code, std::string_view msg) noexcept;
+
+template <typename X>
+constexpr void record_err(const X& e, const call_site& site) noexcept
+{
+#ifdef RESULTS_RECORD
+  if(!std::is_constant_evaluated())
+  {
+    auto summary = summarize_error(e);
+    record_error(record_kind::err, site, summary.code, summary.message);
+  }
+#else
+  (void)e;
+  (void)site;
+#endif
+}
+
+} // namespace internal
+
+} // namespace results
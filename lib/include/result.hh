@@ -1,6 +1,8 @@
 #pragma once
 
 #include "utils.hh"
+#include <exception>
+#include <memory>
 #include <string>
 #include <string_view>
 #include <variant>
@@ -11,10 +13,123 @@ namespace results {
 struct error
 {
   std::string msg;
+#ifdef RESULTS_BACKTRACE
+  // stack at construction, empty unless backtrace sampling is enabled
+  backtrace trace;
+#endif
   error(std::string_view m = "") noexcept;
 };
 
-template <typename T, typename E = error>
+bool operator==(const error& lhs, const error& rhs) noexcept;
+
+bool operator!=(const error& lhs, const error& rhs) noexcept;
+
+bool operator<(const error& lhs, const error& rhs) noexcept;
+
+// Keeps the original exception alive instead of copying its message, see make_from_exception(). The exception is
+// rethrown once at construction to find out whether it is a std::exception; what() and get_if() for std::exception
+// types then get by without throwing.
+class exception_error
+{
+public:
+  exception_error(std::exception_ptr e) noexcept;
+
+  exception_error(const exception_error& other) noexcept = default;
+  exception_error(exception_error&& other) noexcept;
+
+  exception_error& operator=(const exception_error& other) noexcept = default;
+  exception_error& operator=(exception_error&& other) noexcept;
+
+  const std::exception_ptr& exception() const noexcept;
+
+  // rethrow the original exception object, without copying it
+  [[noreturn]] void rethrow() const;
+
+  // the message of a std::exception, "non-std exception" otherwise
+  const char* what() const noexcept;
+
+  // the original exception if it is (derived from) X, nullptr otherwise; rethrows unless X is a std::exception
+  template <typename X>
+  const X* get_if() const noexcept;
+
+private:
+  std::exception_ptr    d_exception;
+  const std::exception* d_std = nullptr; // the object d_exception holds, if it is a std::exception
+};
+
+template <typename T, typename E = error, typename... Es>
+class result;
+
+namespace internal {
+
+// append the Xs that are not in the list yet
+template <typename List, typename... Xs>
+struct append_unique;
+
+template <typename... Ts>
+struct append_unique<type_list<Ts...>>
+{
+  using type = type_list<Ts...>;
+};
+
+template <typename... Ts, typename X, typename... Xs>
+struct append_unique<type_list<Ts...>, X, Xs...>
+  : append_unique<std::conditional_t<contains_v<X, Ts...>, type_list<Ts...>, type_list<Ts..., X>>, Xs...>
+{
+};
+
+template <typename T, typename List>
+struct rebind_result;
+
+template <typename T, typename... Es>
+struct rebind_result<T, type_list<Es...>>
+{
+  using type = result<T, Es...>;
+};
+
+// the result and_then() produces: the value of R, with the union of the error types, existing ones first
+template <typename R, typename List>
+struct widen;
+
+template <typename U, typename... Fs, typename... Es>
+struct widen<result<U, Fs...>, type_list<Es...>>
+{
+  using type = typename rebind_result<U, typename append_unique<type_list<Es...>, Fs...>::type>::type;
+};
+
+template <typename R, typename... Es>
+using widen_t = typename widen<std::decay_t<R>, type_list<Es...>>::type;
+
+template <typename T>
+constexpr bool is_result_v = false;
+
+template <typename T, typename... Es>
+constexpr bool is_result_v<result<T, Es...>> = true;
+
+// the error alternative err(args...) constructs: the one whose type is passed, the first one otherwise
+template <typename ArgList, typename... Es>
+constexpr std::size_t select_error_v = 0;
+
+template <typename A, typename... Es>
+constexpr std::size_t select_error_v<type_list<A>, Es...> = contains_v<A, Es...> ? index_of_v<A, Es...> : 0;
+
+// builds results from values and errors that already exist, without counting or recording them as produced again
+struct result_access
+{
+  template <typename R, typename... Args>
+  static constexpr R ok(Args&&... args);
+
+  // X must be one of the error types of R
+  template <typename R, typename X>
+  static constexpr R err(X&& e);
+};
+
+} // namespace internal
+
+// A value of type T, or an error of one of the types E, Es... . All alternatives share one flat variant, so a result
+// with several error types is as large as its largest member plus a single tag. With more than one error type,
+// match() requires on_err to handle each of them and the _err accessors take the error type to get.
+template <typename T, typename E, typename... Es>
 class result
 {
 private:
@@ -24,30 +139,100 @@ private:
     return d_value.value();
   }
 
+  template <typename U, typename F, typename... Fs>
+  friend class result;
+
+  friend struct internal::result_access;
+
 public:
-  using value_type = T;
-  using error_type = E;
+  using value_type   = T;
+  using error_type   = E;
+  using error_types  = internal::type_list<E, Es...>;
+  using variant_type = std::variant<T, E, Es...>;
+
+  // contstruct; the single argument forms are attributed to their caller by the instrumentation and the recorder, see
+  // instrument.hh. The other forms are attributed to their caller when it passes here() first, otherwise to result.hh.
+  // With fault injection compiled in, ok() may return err(E()) instead, see faults.hh.
+  template <typename A>
+  constexpr static result<T, E, Es...> ok(A&& arg, internal::call_site site = internal::call_site::current()) noexcept;
+
+  template <typename... Args>
+  constexpr static result<T, E, Es...> ok(at_site at, Args&&... args) noexcept;
+
+  template <typename... Args>
+  constexpr static result<T, E, Es...> ok(Args&&... args) noexcept;
+
+  template <typename Alloc, typename... Args>
+  constexpr static result<T, E, Es...> ok(at_site at, std::allocator_arg_t, Alloc&& alloc, Args&&... args) noexcept;
+
+  template <typename Alloc, typename... Args>
+  constexpr static result<T, E, Es...> ok(std::allocator_arg_t, Alloc&& alloc, Args&&... args) noexcept;
+
+  template <typename A>
+  constexpr static result<T, E, Es...> err(A&& arg, internal::call_site site = internal::call_site::current()) noexcept;
 
-  // contstruct
   template <typename... Args>
-  constexpr static result<T, E> ok(Args&&... args) noexcept;
+  constexpr static result<T, E, Es...> err(at_site at, Args&&... args) noexcept;
 
   template <typename... Args>
-  constexpr static result<T, E> err(Args&&... args) noexcept;
+  constexpr static result<T, E, Es...> err(Args&&... args) noexcept;
+
+  template <typename Alloc, typename... Args>
+  constexpr static result<T, E, Es...> err(at_site at, std::allocator_arg_t, Alloc&& alloc, Args&&... args) noexcept;
+
+  template <typename Alloc, typename... Args>
+  constexpr static result<T, E, Es...> err(std::allocator_arg_t, Alloc&& alloc, Args&&... args) noexcept;
+
+  // widening: a result with a subset of these error types converts implicitly
+  template <typename... Fs, typename = std::enable_if_t<(internal::contains_v<Fs, E, Es...> && ...) && !std::is_same_v<result<T, Fs...>, result<T, E, Es...>>>>
+  constexpr result(const result<T, Fs...>& other);
+
+  template <typename... Fs, typename = std::enable_if_t<(internal::contains_v<Fs, E, Es...> && ...) && !std::is_same_v<result<T, Fs...>, result<T, E, Es...>>>>
+  constexpr result(result<T, Fs...>&& other);
+
+  // allocator-extended copy and move, used by allocator-aware containers
+  template <typename Alloc>
+  constexpr result(std::allocator_arg_t, const Alloc& alloc, const result<T, E, Es...>& other);
+
+  template <typename Alloc>
+  constexpr result(std::allocator_arg_t, const Alloc& alloc, result<T, E, Es...>&& other);
+
+  constexpr result(const result<T, E, Es...>&) = default;
+  constexpr result(result<T, E, Es...>&&)      = default;
+
+  result<T, E, Es...>& operator=(const result<T, E, Es...>&) = default;
+  result<T, E, Es...>& operator=(result<T, E, Es...>&&) = default;
 
   // info
   constexpr bool is_ok() const noexcept;
 
   constexpr bool is_err() const noexcept;
 
+  template <typename X = E>
+  constexpr bool holds_err() const noexcept;
+
   // raw access
-  constexpr const T& expect(std::string_view msg) const;
+  constexpr const T& expect(std::string_view msg, internal::call_site site = internal::call_site::current()) const;
+
+  template <typename X = E>
+  constexpr const X& expect_err(std::string_view msg, internal::call_site site = internal::call_site::current()) const;
+
+  constexpr const T& unwrap(internal::call_site site = internal::call_site::current()) const;
+
+  template <typename X = E>
+  constexpr const X& unwrap_err(internal::call_site site = internal::call_site::current()) const;
+
+  // unwrap without checking, the caller guarantees is_ok() or holds_err<X>(); verified in debug builds, see
+  // RESULTS_VERIFY_UNCHECKED
+  constexpr const T& unwrap_unchecked() const noexcept(!RESULTS_VERIFY_UNCHECKED);
 
-  constexpr const E& expect_err(std::string_view msg) const;
+  template <typename X = E>
+  constexpr const X& unwrap_err_unchecked() const noexcept(!RESULTS_VERIFY_UNCHECKED);
 
-  constexpr const T& unwrap() const;
+  // the storage, index 0 holds the value; an rvalue result lets the payload be moved out
+  constexpr const variant_type& as_variant() const& noexcept;
 
-  constexpr const E& unwrap_err() const;
+  constexpr variant_type&& as_variant() && noexcept;
 
   constexpr const T& unwrap_or(const T& other) noexcept;
 
@@ -55,23 +240,23 @@ public:
   T unwrap_or_else(F&& f) const;
 
   // boolean logic
-  constexpr const result<T, E>& and_(const result<T, E>& other) const noexcept;
+  constexpr const result<T, E, Es...>& and_(const result<T, E, Es...>& other) const noexcept;
 
-  constexpr const result<T, E>& or_(const result<T, E>& other) const noexcept;
+  constexpr const result<T, E, Es...>& or_(const result<T, E, Es...>& other) const noexcept;
 
   template <typename F>
-  result<T, E> or_else(F&& f) const;
+  result<T, E, Es...> or_else(F&& f) const;
 
   // match
   template <typename F1, typename F2>
   auto match(F1&& on_ok, F2&& on_err) const -> decltype(on_ok(unwrap()));
 
-  // chaining
+  // chaining: and_then() widens to the union of both error sets
   template <typename F>
-  auto and_then(F&& f) const -> decltype(f(unwrap()));
+  auto and_then(F&& f) const -> internal::widen_t<decltype(f(unwrap())), E, Es...>;
 
   template <typename F>
-  auto map(F&& f) const -> result<return_wrapper_t<decltype(f(unwrap()))>, error_type>;
+  auto map(F&& f) const -> result<return_wrapper_t<decltype(f(unwrap()))>, E, Es...>;
 
   template <typename F>
   auto map_err(F&& f) const -> result<value_type, std::decay_t<decltype(f(unwrap_err()))>>;
@@ -80,222 +265,705 @@ public:
   auto map_or_else(F1&& f, const F2& def) const -> decltype(f(unwrap()));
 
   template <typename F>
-  auto consume(F&& f) -> result<return_wrapper_t<decltype(f(value()))>, error_type>;
+  auto consume(F&& f) -> result<return_wrapper_t<decltype(f(value()))>, E, Es...>;
+
+  // misc: result<result<U, Fs...>, E, Es...> to result<U, ...> with the union of the error types
+  constexpr auto flatten() const&;
+
+  constexpr auto flatten() &&;
 
 private:
-  template <typename... Args>
-  constexpr result(Args&&... args);
+  template <std::size_t I, typename... Args>
+  constexpr result(std::in_place_index_t<I> idx, Args&&... args);
+
+  template <std::size_t I, typename... Args>
+  constexpr static result<T, E, Es...> emplace(Args&&... args);
+
+  template <std::size_t I, typename Alloc, typename... Args>
+  constexpr static result<T, E, Es...> emplace_using_allocator(const Alloc& alloc, Args&&... args);
+
+  // move or copy the error of v into a result of type R, which has a superset of the error types; copies of errors
+  // with an allocator are made with that allocator, so that errors stay in their arena as they are passed on
+  template <typename R, typename V>
+  constexpr static R rewrap_err(V&& v);
 
   constexpr const T& get_ok() const noexcept;
 
-  constexpr const E& get_err() const noexcept;
+  template <typename X = E>
+  constexpr const X& get_err() const noexcept;
 
   enum {
     OK  = 0,
     ERR = 1,
   };
 
-  std::variant<T, E> d_value;
+  static constexpr std::size_t alternatives = 2 + sizeof...(Es);
+
+  template <typename X>
+  static constexpr std::size_t err_index = 1 + internal::index_of_v<X, E, Es...>;
+
+  variant_type d_value;
 };
 
+template <typename T, typename E = error, typename A>
+constexpr result<T, E> make_ok(A&& arg, internal::call_site site = internal::call_site::current()) noexcept
+{
+  return result<T, E>::ok(std::forward<A>(arg), site);
+}
+
+template <typename T, typename E = error, typename... Args>
+constexpr result<T, E> make_ok(at_site at, Args&&... args) noexcept
+{
+  return result<T, E>::ok(at, std::forward<Args>(args)...);
+}
+
 template <typename T, typename E = error, typename... Args>
 constexpr result<T, E> make_ok(Args&&... args) noexcept
 {
   return result<T, E>::ok(std::forward<Args>(args)...);
 }
 
+template <typename T, typename E = error, typename A>
+constexpr result<T, E> make_err(A&& arg, internal::call_site site = internal::call_site::current()) noexcept
+{
+  return result<T, E>::err(std::forward<A>(arg), site);
+}
+
+template <typename T, typename E = error, typename... Args>
+constexpr result<T, E> make_err(at_site at, Args&&... args) noexcept
+{
+  return result<T, E>::err(at, std::forward<Args>(args)...);
+}
+
 template <typename T, typename E = error, typename... Args>
 constexpr result<T, E> make_err(Args&&... args) noexcept
 {
   return result<T, E>::err(std::forward<Args>(args)...);
 }
 
+// Calls f() and catches what it throws. Error types constructible from std::exception_ptr keep the exception itself,
+// others are constructed from its what(). Callables marked noexcept are called without a try block. Errors are
+// attributed to the caller by the instrumentation and the recorder.
 template <typename F, typename E = error>
-auto make_from_throwable(F && f) noexcept -> result<std::decay_t<decltype(f())>, E>
+auto make_from_throwable(F && f, internal::call_site site = internal::call_site::current()) noexcept -> result<std::decay_t<decltype(f())>, E>
 {
   using R = result<std::decay_t<decltype(f())>, E>;
-  try
+  if constexpr(noexcept(f()))
   {
     return R::ok(f());
   }
-  catch(const std::exception &e)
+  else if constexpr(std::is_constructible_v<E, std::exception_ptr>)
+  {
+    try
+    {
+      return R::ok(f());
+    }
+    catch(...)
+    {
+      return R::err(std::current_exception(), site);
+    }
+  }
+  else
+  {
+    try
+    {
+      return R::ok(f());
+    }
+    catch(const std::exception &e)
+    {
+      return R::err(e.what(), site);
+    }
+    catch(...)
+    {
+      return R::err("non-std exception", site);
+    }
+  }
+}
+
+template <typename F>
+auto make_from_exception(F && f, internal::call_site site = internal::call_site::current()) noexcept -> result<std::decay_t<decltype(f())>, exception_error>
+{
+  return make_from_throwable<F, exception_error>(std::forward<F>(f), site);
+}
+
+template <typename X>
+const X* exception_error::get_if() const noexcept
+{
+  if constexpr(std::is_base_of_v<std::exception, X>)
+  {
+    return dynamic_cast<const X*>(d_std);
+  }
+  else
   {
-    return R::err(e.what());
+    if(!d_exception)
+    {
+      return nullptr;
+    }
+    try
+    {
+      rethrow();
+    }
+    catch(const X& x)
+    {
+      return &x;
+    }
+    catch(...)
+    {
+    }
+    return nullptr;
   }
-  catch(...)
+}
+
+
+template <typename T, typename E, typename... Es>
+template <typename A>
+constexpr result<T, E, Es...> result<T, E, Es...>::ok(A&& arg, internal::call_site site) noexcept
+{
+  if constexpr(std::is_nothrow_default_constructible_v<E>)
   {
-    return R::err("non-std exception");
+    if(internal::inject_fault(site))
+    {
+      return err(E(), site);
+    }
   }
+  internal::record_site(site_kind::ok, site);
+  return emplace<OK>(std::forward<A>(arg));
 }
 
+template <typename T, typename E, typename... Es>
+template <typename... Args>
+constexpr result<T, E, Es...> result<T, E, Es...>::ok(at_site at, Args&&... args) noexcept
+{
+  if constexpr(std::is_nothrow_default_constructible_v<E>)
+  {
+    if(internal::inject_fault(at.site))
+    {
+      return err(E(), at.site);
+    }
+  }
+  internal::record_site(site_kind::ok, at.site);
+  return emplace<OK>(std::forward<Args>(args)...);
+}
 
-template <typename T, typename E>
+template <typename T, typename E, typename... Es>
 template <typename... Args>
-constexpr result<T, E> result<T, E>::ok(Args&&... args) noexcept
+constexpr result<T, E, Es...> result<T, E, Es...>::ok(Args&&... args) noexcept
+{
+  return ok(here(), std::forward<Args>(args)...);
+}
+
+template <typename T, typename E, typename... Es>
+template <typename Alloc, typename... Args>
+constexpr result<T, E, Es...> result<T, E, Es...>::ok(at_site at, std::allocator_arg_t, Alloc&& alloc, Args&&... args) noexcept
+{
+  internal::record_site(site_kind::ok, at.site);
+  return emplace_using_allocator<OK>(alloc, std::forward<Args>(args)...);
+}
+
+template <typename T, typename E, typename... Es>
+template <typename Alloc, typename... Args>
+constexpr result<T, E, Es...> result<T, E, Es...>::ok(std::allocator_arg_t, Alloc&& alloc, Args&&... args) noexcept
+{
+  return ok(here(), std::allocator_arg, std::forward<Alloc>(alloc), std::forward<Args>(args)...);
+}
+
+template <typename T, typename E, typename... Es>
+template <typename A>
+constexpr result<T, E, Es...> result<T, E, Es...>::err(A&& arg, internal::call_site site) noexcept
 {
-  return result<T, E>(std::in_place_index<OK>, std::forward<Args>(args)...);
+  internal::record_site(site_kind::err, site);
+  constexpr auto I = ERR + internal::select_error_v<internal::type_list<std::decay_t<A>>, E, Es...>;
+  auto r           = emplace<I>(std::forward<A>(arg));
+  internal::record_err(*std::get_if<I>(&r.d_value), site);
+  return r;
 }
 
-template <typename T, typename E>
+template <typename T, typename E, typename... Es>
 template <typename... Args>
-constexpr result<T, E> result<T, E>::err(Args&&... args) noexcept
+constexpr result<T, E, Es...> result<T, E, Es...>::err(at_site at, Args&&... args) noexcept
 {
-  return result<T, E>(std::in_place_index<ERR>, std::forward<Args>(args)...);
+  internal::record_site(site_kind::err, at.site);
+  constexpr auto I = ERR + internal::select_error_v<internal::type_list<std::decay_t<Args>...>, E, Es...>;
+  auto r           = emplace<I>(std::forward<Args>(args)...);
+  internal::record_err(*std::get_if<I>(&r.d_value), at.site);
+  return r;
 }
 
-template <typename T, typename E>
+template <typename T, typename E, typename... Es>
 template <typename... Args>
-constexpr result<T, E>::result(Args&&... args)
-  : d_value(std::forward<Args>(args)...)
+constexpr result<T, E, Es...> result<T, E, Es...>::err(Args&&... args) noexcept
+{
+  return err(here(), std::forward<Args>(args)...);
+}
+
+template <typename T, typename E, typename... Es>
+template <typename Alloc, typename... Args>
+constexpr result<T, E, Es...> result<T, E, Es...>::err(at_site at, std::allocator_arg_t, Alloc&& alloc, Args&&... args) noexcept
 {
+  internal::record_site(site_kind::err, at.site);
+  constexpr auto I = ERR + internal::select_error_v<internal::type_list<std::decay_t<Args>...>, E, Es...>;
+  auto r           = emplace_using_allocator<I>(alloc, std::forward<Args>(args)...);
+  internal::record_err(*std::get_if<I>(&r.d_value), at.site);
+  return r;
 }
 
-template <typename T, typename E>
-constexpr bool result<T, E>::is_ok() const noexcept
+template <typename T, typename E, typename... Es>
+template <typename Alloc, typename... Args>
+constexpr result<T, E, Es...> result<T, E, Es...>::err(std::allocator_arg_t, Alloc&& alloc, Args&&... args) noexcept
+{
+  return err(here(), std::allocator_arg, std::forward<Alloc>(alloc), std::forward<Args>(args)...);
+}
+
+template <typename T, typename E, typename... Es>
+template <typename... Fs, typename>
+constexpr result<T, E, Es...>::result(const result<T, Fs...>& other)
+  : result(other.is_ok() ? emplace<OK>(other.get_ok()) : result<T, Fs...>::template rewrap_err<result<T, E, Es...>>(other.d_value))
+{
+}
+
+template <typename T, typename E, typename... Es>
+template <typename... Fs, typename>
+constexpr result<T, E, Es...>::result(result<T, Fs...>&& other)
+  : result(other.is_ok() ? emplace<OK>(std::move(std::get<OK>(other.d_value))) : result<T, Fs...>::template rewrap_err<result<T, E, Es...>>(std::move(other.d_value)))
+{
+}
+
+template <typename T, typename E, typename... Es>
+template <typename Alloc>
+constexpr result<T, E, Es...>::result(std::allocator_arg_t, const Alloc& alloc, const result<T, E, Es...>& other)
+  : result(internal::visit_index<result<T, E, Es...>, 0, alternatives>(other.d_value.index(), [&](auto i) {
+    return emplace_using_allocator<i>(alloc, std::get<i>(other.d_value));
+  }))
+{
+}
+
+template <typename T, typename E, typename... Es>
+template <typename Alloc>
+constexpr result<T, E, Es...>::result(std::allocator_arg_t, const Alloc& alloc, result<T, E, Es...>&& other)
+  : result(internal::visit_index<result<T, E, Es...>, 0, alternatives>(other.d_value.index(), [&](auto i) {
+    return emplace_using_allocator<i>(alloc, std::move(std::get<i>(other.d_value)));
+  }))
+{
+}
+
+template <typename T, typename E, typename... Es>
+template <std::size_t I, typename... Args>
+constexpr result<T, E, Es...>::result(std::in_place_index_t<I> idx, Args&&... args)
+  : d_value(idx, std::forward<Args>(args)...)
+{
+}
+
+template <typename T, typename E, typename... Es>
+template <std::size_t I, typename... Args>
+constexpr result<T, E, Es...> result<T, E, Es...>::emplace(Args&&... args)
+{
+  return result<T, E, Es...>(std::in_place_index<I>, std::forward<Args>(args)...);
+}
+
+template <typename T, typename E, typename... Es>
+template <std::size_t I, typename Alloc, typename... Args>
+constexpr result<T, E, Es...> result<T, E, Es...>::emplace_using_allocator(const Alloc& alloc, Args&&... args)
+{
+  return internal::construct_using_allocator<std::variant_alternative_t<I, variant_type>>(
+      [](auto&&... a) { return result<T, E, Es...>(std::in_place_index<I>, std::forward<decltype(a)>(a)...); },
+      alloc,
+      std::forward<Args>(args)...);
+}
+
+template <typename T, typename E, typename... Es>
+template <typename R, typename V>
+constexpr R result<T, E, Es...>::rewrap_err(V&& v)
+{
+  return internal::visit_index<R, ERR, alternatives>(v.index(), [&](auto i) {
+    using X = std::variant_alternative_t<i, variant_type>;
+    if constexpr(std::is_lvalue_reference_v<V> && internal::has_allocator_v<X>)
+    {
+      const auto& e = std::get<i>(v);
+      return R::template emplace_using_allocator<R::template err_index<X>>(e.get_allocator(), e);
+    }
+    else
+    {
+      return R::template emplace<R::template err_index<X>>(std::get<i>(std::forward<V>(v)));
+    }
+  });
+}
+
+template <typename R, typename... Args>
+constexpr R internal::result_access::ok(Args&&... args)
+{
+  return R::template emplace<R::OK>(std::forward<Args>(args)...);
+}
+
+template <typename R, typename X>
+constexpr R internal::result_access::err(X&& e)
+{
+  return R::template emplace<R::template err_index<std::decay_t<X>>>(std::forward<X>(e));
+}
+
+template <typename T, typename E, typename... Es>
+constexpr bool result<T, E, Es...>::is_ok() const noexcept
 {
   return d_value.index() == OK;
 }
 
-template <typename T, typename E>
-constexpr bool result<T, E>::is_err() const noexcept
+template <typename T, typename E, typename... Es>
+constexpr bool result<T, E, Es...>::is_err() const noexcept
+{
+  return d_value.index() != OK;
+}
+
+template <typename T, typename E, typename... Es>
+template <typename X>
+constexpr bool result<T, E, Es...>::holds_err() const noexcept
 {
-  return d_value.index() == ERR;
+  static_assert(internal::contains_v<X, E, Es...>, "X must be one of the error types");
+  return d_value.index() == err_index<X>;
 }
 
-template <typename T, typename E>
-constexpr const T& result<T, E>::expect(std::string_view msg) const
+template <typename T, typename E, typename... Es>
+constexpr const T& result<T, E, Es...>::expect(std::string_view msg, internal::call_site site) const
 {
+  internal::record_site(site_kind::expect, site);
   if(!is_ok())
   {
-    internal::panic(msg);
+    internal::panic(msg, site);
   }
   return get_ok();
 }
 
-template <typename T, typename E>
-constexpr const T& result<T, E>::unwrap() const
+template <typename T, typename E, typename... Es>
+constexpr const T& result<T, E, Es...>::unwrap(internal::call_site site) const
 {
-  return expect("unwrapping err");
+  return expect("unwrapping err", site);
 }
 
-template <typename T, typename E>
-constexpr const T& result<T, E>::get_ok() const noexcept
+template <typename T, typename E, typename... Es>
+constexpr const T& result<T, E, Es...>::get_ok() const noexcept
 {
   return std::get<OK>(d_value);
 }
 
-template <typename T, typename E>
-constexpr const E& result<T, E>::get_err() const noexcept
+template <typename T, typename E, typename... Es>
+template <typename X>
+constexpr const X& result<T, E, Es...>::get_err() const noexcept
 {
-  return std::get<ERR>(d_value);
+  return std::get<err_index<X>>(d_value);
 }
 
-template <typename T, typename E>
-constexpr const result<T, E>& result<T, E>::and_(const result<T, E>& other) const noexcept
+template <typename T, typename E, typename... Es>
+constexpr const result<T, E, Es...>& result<T, E, Es...>::and_(const result<T, E, Es...>& other) const noexcept
 {
   return is_ok() ? other : *this;
 }
 
-template <typename T, typename E>
-constexpr const result<T, E>& result<T, E>::or_(const result<T, E>& other) const noexcept
+template <typename T, typename E, typename... Es>
+constexpr const result<T, E, Es...>& result<T, E, Es...>::or_(const result<T, E, Es...>& other) const noexcept
 {
   return is_err() ? other : *this;
 }
 
-template <typename T, typename E>
+template <typename T, typename E, typename... Es>
 template <typename F>
-result<T, E> result<T, E>::or_else(F&& f) const
+result<T, E, Es...> result<T, E, Es...>::or_else(F&& f) const
 {
   return is_ok() ? *this : f();
 }
 
-template <typename T, typename E>
-constexpr const E& result<T, E>::expect_err(std::string_view msg) const
+template <typename T, typename E, typename... Es>
+template <typename X>
+constexpr const X& result<T, E, Es...>::expect_err(std::string_view msg, internal::call_site site) const
 {
-  if(!is_err())
+  internal::record_site(site_kind::expect, site);
+  if(!holds_err<X>())
   {
-    internal::panic(msg);
+    internal::panic(msg, site);
   }
-  return get_err();
+  return get_err<X>();
+}
+
+template <typename T, typename E, typename... Es>
+template <typename X>
+constexpr const X& result<T, E, Es...>::unwrap_err(internal::call_site site) const
+{
+  return expect_err<X>("unwrapping ok", site);
+}
+
+template <typename T, typename E, typename... Es>
+constexpr const T& result<T, E, Es...>::unwrap_unchecked() const noexcept(!RESULTS_VERIFY_UNCHECKED)
+{
+  internal::assume(is_ok(), "unwrapping err unchecked");
+  return *std::get_if<OK>(&d_value);
+}
+
+template <typename T, typename E, typename... Es>
+template <typename X>
+constexpr const X& result<T, E, Es...>::unwrap_err_unchecked() const noexcept(!RESULTS_VERIFY_UNCHECKED)
+{
+  internal::assume(holds_err<X>(), "unwrapping ok unchecked");
+  return *std::get_if<err_index<X>>(&d_value);
+}
+
+template <typename T, typename E, typename... Es>
+constexpr auto result<T, E, Es...>::as_variant() const& noexcept -> const variant_type&
+{
+  return d_value;
 }
 
-template <typename T, typename E>
-constexpr const E& result<T, E>::unwrap_err() const
+template <typename T, typename E, typename... Es>
+constexpr auto result<T, E, Es...>::as_variant() && noexcept -> variant_type&&
 {
-  return expect_err("unwrapping ok");
+  return std::move(d_value);
 }
 
-template <typename T, typename E>
-constexpr const T& result<T, E>::unwrap_or(const T& other) noexcept
+template <typename T, typename E, typename... Es>
+constexpr const T& result<T, E, Es...>::unwrap_or(const T& other) noexcept
 {
   return is_ok() ? get_ok() : other;
 }
 
-template <typename T, typename E>
+template <typename T, typename E, typename... Es>
 template <typename F>
-T result<T, E>::unwrap_or_else(F&& f) const
+T result<T, E, Es...>::unwrap_or_else(F&& f) const
 {
   return is_ok() ? get_ok() : f();
 }
 
-template <typename T, typename E>
+template <typename T, typename E, typename... Es>
 template <typename F>
-auto result<T, E>::and_then(F&& f) const -> decltype(f(unwrap()))
+auto result<T, E, Es...>::and_then(F&& f) const -> internal::widen_t<decltype(f(unwrap())), E, Es...>
 {
-  using U = decltype(f(unwrap()));
-  return match(
-      [&](auto&& ok) { return f(ok); },
-      [](auto&& err) { return make_err<typename U::value_type, typename U::error_type>(err); });
+  using U = internal::widen_t<decltype(f(unwrap())), E, Es...>;
+  if(is_ok())
+  {
+    return f(get_ok());
+  }
+  return rewrap_err<U>(d_value);
 }
 
-template <typename T, typename E>
+template <typename T, typename E, typename... Es>
 template <typename F1, typename F2>
-auto result<T, E>::match(F1&& on_ok, F2&& on_err) const -> decltype(on_ok(unwrap()))
+auto result<T, E, Es...>::match(F1&& on_ok, F2&& on_err) const -> decltype(on_ok(unwrap()))
 {
-  static_assert(std::is_convertible<decltype(on_err(get_err())), decltype(on_ok(get_ok()))>::value,
+  using R = decltype(on_ok(get_ok()));
+  static_assert((std::is_invocable_v<F2&, const E&> && ... && std::is_invocable_v<F2&, const Es&>),
+                "on_err() must handle every error type");
+  static_assert((std::is_convertible_v<std::invoke_result_t<F2&, const E&>, R> && ... && std::is_convertible_v<std::invoke_result_t<F2&, const Es&>, R>),
                 "return value of on_err() must be equal or convertible to the return value of on_ok()");
-  return is_ok() ? on_ok(get_ok()) : on_err(get_err());
+
+  if(is_ok())
+  {
+    return on_ok(get_ok());
+  }
+  return internal::visit_index<R, ERR, alternatives>(d_value.index(), [&](auto i) -> R {
+    return on_err(std::get<i>(d_value));
+  });
 }
 
-template <typename T, typename E>
+template <typename T, typename E, typename... Es>
 template <typename F>
-auto result<T, E>::map(F&& f) const -> result<return_wrapper_t<decltype(f(unwrap()))>, error_type>
+auto result<T, E, Es...>::map(F&& f) const -> result<return_wrapper_t<decltype(f(unwrap()))>, E, Es...>
 {
   using R = return_wrapper<decltype(f(unwrap()))>;
-  using U = typename R::type;
-  return match(
-      [&](auto&& ok) { return make_ok<U, E>(R::call(f, ok)); },
-      [](auto&& err) { return make_err<U, E>(err); });
+  using U = result<typename R::type, E, Es...>;
+  if(is_ok())
+  {
+    return U::template emplace<OK>(R::call(f, get_ok()));
+  }
+  return rewrap_err<U>(d_value);
 }
 
-template <typename T, typename E>
+template <typename T, typename E, typename... Es>
 template <typename F>
-auto result<T, E>::map_err(F&& f) const -> result<value_type, std::decay_t<decltype(f(unwrap_err()))>>
+auto result<T, E, Es...>::map_err(F&& f) const -> result<value_type, std::decay_t<decltype(f(unwrap_err()))>>
 {
-  using U = decltype(f(unwrap_err()));
+  using U = result<value_type, std::decay_t<decltype(f(unwrap_err()))>>;
   return match(
-      [](auto&& ok) { return make_ok<T, U>(ok); },
-      [&](auto&& err) { return make_err<T, U>(f(err)); });
+      [](auto&& ok) { return U::template emplace<OK>(ok); },
+      [&](auto&& err) { return U::template emplace<ERR>(f(err)); });
 }
 
-template <typename T, typename E>
+template <typename T, typename E, typename... Es>
 template <typename F1, typename F2>
-auto result<T, E>::map_or_else(F1&& f, const F2& def) const -> decltype(f(unwrap()))
+auto result<T, E, Es...>::map_or_else(F1&& f, const F2& def) const -> decltype(f(unwrap()))
 {
   return match(f, def);
 }
 
-template <typename T, typename E>
+template <typename T, typename E, typename... Es>
 template <typename F>
-auto result<T, E>::consume(F&& f) -> result<return_wrapper_t<decltype(f(value()))>, error_type>
+auto result<T, E, Es...>::consume(F&& f) -> result<return_wrapper_t<decltype(f(value()))>, E, Es...>
 {
   using R = return_wrapper<decltype(f(value()))>;
-  using U = typename R::type;
+  using U = result<typename R::type, E, Es...>;
 
   if (is_ok())
-    return make_ok<U, E>(R::call(f, std::move(std::get<OK>(d_value))));
-  return make_err<U, E>(std::move(std::get<ERR>(d_value)));
+    return U::template emplace<OK>(R::call(f, std::move(std::get<OK>(d_value))));
+  return rewrap_err<U>(std::move(d_value));
+}
+
+
+template <typename T, typename E, typename... Es>
+constexpr auto result<T, E, Es...>::flatten() const&
+{
+  static_assert(internal::is_result_v<T>, "contained type must be a result itself");
+  using U = internal::widen_t<T, E, Es...>;
+
+  if(is_ok())
+  {
+    return U(get_ok());
+  }
+  return rewrap_err<U>(d_value);
+}
+
+template <typename T, typename E, typename... Es>
+constexpr auto result<T, E, Es...>::flatten() &&
+{
+  static_assert(internal::is_result_v<T>, "contained type must be a result itself");
+  using U = internal::widen_t<T, E, Es...>;
+
+  if(is_ok())
+  {
+    return U(std::move(std::get<OK>(d_value)));
+  }
+  return rewrap_err<U>(std::move(d_value));
+}
+
+// comparison: any ok compares less than any err, values of the same kind compare by value
+template <typename T, typename... Es>
+constexpr bool operator==(const result<T, Es...>& lhs, const result<T, Es...>& rhs)
+{
+  return lhs.as_variant() == rhs.as_variant();
+}
+
+template <typename T, typename... Es>
+constexpr bool operator!=(const result<T, Es...>& lhs, const result<T, Es...>& rhs)
+{
+  return !(lhs == rhs);
+}
+
+template <typename T, typename... Es>
+constexpr bool operator<(const result<T, Es...>& lhs, const result<T, Es...>& rhs)
+{
+  // ok is the first alternative, the variant orders by index first
+  return lhs.as_variant() < rhs.as_variant();
+}
+
+template <typename T, typename... Es>
+constexpr bool operator>(const result<T, Es...>& lhs, const result<T, Es...>& rhs)
+{
+  return rhs < lhs;
+}
+
+template <typename T, typename... Es>
+constexpr bool operator<=(const result<T, Es...>& lhs, const result<T, Es...>& rhs)
+{
+  return !(rhs < lhs);
+}
+
+template <typename T, typename... Es>
+constexpr bool operator>=(const result<T, Es...>& lhs, const result<T, Es...>& rhs)
+{
+  return !(lhs < rhs);
+}
+
+// mixed comparison: a bare value compares as ok(value)
+template <typename T, typename... Es>
+constexpr bool operator==(const result<T, Es...>& lhs, const typename result<T, Es...>::value_type& rhs)
+{
+  return lhs.is_ok() && lhs.unwrap_unchecked() == rhs;
+}
+
+template <typename T, typename... Es>
+constexpr bool operator==(const typename result<T, Es...>::value_type& lhs, const result<T, Es...>& rhs)
+{
+  return rhs == lhs;
+}
+
+template <typename T, typename... Es>
+constexpr bool operator!=(const result<T, Es...>& lhs, const typename result<T, Es...>::value_type& rhs)
+{
+  return !(lhs == rhs);
+}
+
+template <typename T, typename... Es>
+constexpr bool operator!=(const typename result<T, Es...>::value_type& lhs, const result<T, Es...>& rhs)
+{
+  return !(rhs == lhs);
+}
+
+template <typename T, typename... Es>
+constexpr bool operator<(const result<T, Es...>& lhs, const typename result<T, Es...>::value_type& rhs)
+{
+  return lhs.is_ok() && lhs.unwrap_unchecked() < rhs;
+}
+
+template <typename T, typename... Es>
+constexpr bool operator<(const typename result<T, Es...>::value_type& lhs, const result<T, Es...>& rhs)
+{
+  return rhs.is_err() || lhs < rhs.unwrap_unchecked();
+}
+
+template <typename T, typename... Es>
+constexpr bool operator>(const result<T, Es...>& lhs, const typename result<T, Es...>::value_type& rhs)
+{
+  return rhs < lhs;
+}
+
+template <typename T, typename... Es>
+constexpr bool operator>(const typename result<T, Es...>::value_type& lhs, const result<T, Es...>& rhs)
+{
+  return rhs < lhs;
+}
+
+template <typename T, typename... Es>
+constexpr bool operator<=(const result<T, Es...>& lhs, const typename result<T, Es...>::value_type& rhs)
+{
+  return !(rhs < lhs);
+}
+
+template <typename T, typename... Es>
+constexpr bool operator<=(const typename result<T, Es...>::value_type& lhs, const result<T, Es...>& rhs)
+{
+  return !(rhs < lhs);
+}
+
+template <typename T, typename... Es>
+constexpr bool operator>=(const result<T, Es...>& lhs, const typename result<T, Es...>::value_type& rhs)
+{
+  return !(lhs < rhs);
 }
 
+template <typename T, typename... Es>
+constexpr bool operator>=(const typename result<T, Es...>::value_type& lhs, const result<T, Es...>& rhs)
+{
+  return !(lhs < rhs);
+}
 
 } // namespace results
+
+namespace std {
+
+template <>
+struct hash<results::error>
+{
+  size_t operator()(const results::error& e) const noexcept;
+};
+
+template <typename T, typename... Es>
+  requires results::internal::is_hashable_v<T> && (results::internal::is_hashable_v<Es> && ...)
+struct hash<results::result<T, Es...>>
+{
+  size_t operator()(const results::result<T, Es...>& r) const noexcept
+  {
+    const auto& v = r.as_variant();
+    return visit([&](const auto& x) { return results::internal::hash_with_tag(x, v.index()); }, v);
+  }
+};
+
+template <typename T, typename... Es, typename Alloc>
+struct uses_allocator<results::result<T, Es...>, Alloc>
+  : bool_constant<uses_allocator_v<T, Alloc> || (uses_allocator_v<Es, Alloc> || ...)>
+{
+};
+
+} // namespace std
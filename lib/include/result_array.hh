@@ -0,0 +1,357 @@
+#pragma once
+
+#include "result.hh"
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace results {
+
+// A sequence of result<T, E> stored as a structure of arrays, for bulk work where errors are rare: values are dense in
+// one vector, a bitmap marks the failed elements and their errors live in a side table ordered by index. Each element
+// costs sizeof(T) plus one bit; an error costs its index and payload on top. The value slot of a failed element holds
+// a value-initialized T.
+//
+// Elements are read back as result<T, E> copies or, without copying, as results of references. values() exposes the
+// dense array for kernels that check error_count() first; map() and for_each_ok() skip failed elements a word of the
+// bitmap at a time and run a plain, vectorizable loop over words without failures.
+template <typename T, typename E = error>
+class result_array
+{
+  static_assert(std::is_default_constructible_v<T>, "failed elements hold a default constructed value");
+  static_assert(!std::is_same_v<T, bool>, "values are stored in a std::vector, use a byte sized type instead of bool");
+
+  template <typename U, typename F>
+  friend class result_array;
+
+public:
+  using value_type = result<T, E>;
+  using reference  = result<std::reference_wrapper<const T>, std::reference_wrapper<const E>>;
+
+  result_array() = default;
+
+  // append
+  void push_back(const result<T, E>& r);
+
+  void push_back(result<T, E>&& r);
+
+  template <typename... Args>
+  void emplace_ok(Args&&... args);
+
+  template <typename... Args>
+  void emplace_err(Args&&... args);
+
+  // replace element i with an error
+  template <typename... Args>
+  void set_err(std::size_t i, Args&&... args);
+
+  void reserve(std::size_t n);
+
+  void clear() noexcept;
+
+  // info
+  std::size_t size() const noexcept;
+
+  bool empty() const noexcept;
+
+  std::size_t error_count() const noexcept;
+
+  bool is_ok(std::size_t i) const noexcept;
+
+  bool is_err(std::size_t i) const noexcept;
+
+  // element access
+  result<T, E> operator[](std::size_t i) const;
+
+  reference ref(std::size_t i) const;
+
+  // the caller guarantees is_ok(i) or is_err(i); verified in debug builds, see RESULTS_VERIFY_UNCHECKED
+  const T& value_unchecked(std::size_t i) const noexcept(!RESULTS_VERIFY_UNCHECKED);
+
+  const E& error_unchecked(std::size_t i) const noexcept(!RESULTS_VERIFY_UNCHECKED);
+
+  // the dense values, failed elements included
+  std::span<const T> values() const noexcept;
+
+  // one bit per element, set for failed ones; bit i % 64 of word i / 64
+  std::span<const std::uint64_t> error_bits() const noexcept;
+
+  // the errors with their indices, by index
+  std::span<const std::pair<std::size_t, E>> errors() const noexcept;
+
+  // bulk: f(value) for each ok element, errors are carried over
+  template <typename F>
+  auto map(F&& f) const -> result_array<std::decay_t<std::invoke_result_t<F&, const T&>>, E>;
+
+  // f(index, value) for each ok element
+  template <typename F>
+  void for_each_ok(F&& f) const;
+
+  std::vector<result<T, E>> to_vector() const;
+
+private:
+  static constexpr std::size_t word_bits = 64;
+
+  void mark(std::size_t i) noexcept;
+
+  const E* find_error(std::size_t i) const noexcept;
+
+  std::vector<T>                         d_values;
+  std::vector<std::uint64_t>             d_bits; // one word per 64 elements
+  std::vector<std::pair<std::size_t, E>> d_errors;
+};
+
+template <typename T, typename E>
+void result_array<T, E>::push_back(const result<T, E>& r)
+{
+  if(r.is_ok())
+  {
+    emplace_ok(r.unwrap_unchecked());
+  }
+  else
+  {
+    emplace_err(r.unwrap_err_unchecked());
+  }
+}
+
+template <typename T, typename E>
+void result_array<T, E>::push_back(result<T, E>&& r)
+{
+  if(r.is_ok())
+  {
+    emplace_ok(std::get<0>(std::move(r).as_variant()));
+  }
+  else
+  {
+    emplace_err(std::get<1>(std::move(r).as_variant()));
+  }
+}
+
+template <typename T, typename E>
+template <typename... Args>
+void result_array<T, E>::emplace_ok(Args&&... args)
+{
+  if(d_values.size() % word_bits == 0)
+  {
+    d_bits.push_back(0);
+  }
+  d_values.emplace_back(std::forward<Args>(args)...);
+}
+
+template <typename T, typename E>
+template <typename... Args>
+void result_array<T, E>::emplace_err(Args&&... args)
+{
+  d_errors.emplace_back(std::piecewise_construct, std::forward_as_tuple(d_values.size()), std::forward_as_tuple(std::forward<Args>(args)...));
+  emplace_ok();
+  mark(d_values.size() - 1);
+}
+
+template <typename T, typename E>
+template <typename... Args>
+void result_array<T, E>::set_err(std::size_t i, Args&&... args)
+{
+  auto it = std::lower_bound(d_errors.begin(), d_errors.end(), i, [](const auto& e, std::size_t idx) {
+    return e.first < idx;
+  });
+  if(it != d_errors.end() && it->first == i)
+  {
+    it->second = E(std::forward<Args>(args)...);
+  }
+  else
+  {
+    d_errors.emplace(it, std::piecewise_construct, std::forward_as_tuple(i), std::forward_as_tuple(std::forward<Args>(args)...));
+  }
+  d_values[i] = T();
+  mark(i);
+}
+
+template <typename T, typename E>
+void result_array<T, E>::reserve(std::size_t n)
+{
+  d_values.reserve(n);
+  d_bits.reserve((n + word_bits - 1) / word_bits);
+}
+
+template <typename T, typename E>
+void result_array<T, E>::clear() noexcept
+{
+  d_values.clear();
+  d_bits.clear();
+  d_errors.clear();
+}
+
+template <typename T, typename E>
+std::size_t result_array<T, E>::size() const noexcept
+{
+  return d_values.size();
+}
+
+template <typename T, typename E>
+bool result_array<T, E>::empty() const noexcept
+{
+  return d_values.empty();
+}
+
+template <typename T, typename E>
+std::size_t result_array<T, E>::error_count() const noexcept
+{
+  return d_errors.size();
+}
+
+template <typename T, typename E>
+bool result_array<T, E>::is_ok(std::size_t i) const noexcept
+{
+  return !is_err(i);
+}
+
+template <typename T, typename E>
+bool result_array<T, E>::is_err(std::size_t i) const noexcept
+{
+  return (d_bits[i / word_bits] >> (i % word_bits)) & 1;
+}
+
+template <typename T, typename E>
+result<T, E> result_array<T, E>::operator[](std::size_t i) const
+{
+  if(is_ok(i))
+  {
+    return internal::result_access::ok<result<T, E>>(d_values[i]);
+  }
+  return internal::result_access::err<result<T, E>>(*find_error(i));
+}
+
+template <typename T, typename E>
+auto result_array<T, E>::ref(std::size_t i) const -> reference
+{
+  if(is_ok(i))
+  {
+    return internal::result_access::ok<reference>(std::cref(d_values[i]));
+  }
+  return internal::result_access::err<reference>(std::cref(*find_error(i)));
+}
+
+template <typename T, typename E>
+const T& result_array<T, E>::value_unchecked(std::size_t i) const noexcept(!RESULTS_VERIFY_UNCHECKED)
+{
+  internal::assume(is_ok(i), "reading the value of a failed element unchecked");
+  return d_values[i];
+}
+
+template <typename T, typename E>
+const E& result_array<T, E>::error_unchecked(std::size_t i) const noexcept(!RESULTS_VERIFY_UNCHECKED)
+{
+  internal::assume(is_err(i), "reading the error of an ok element unchecked");
+  return *find_error(i);
+}
+
+template <typename T, typename E>
+std::span<const T> result_array<T, E>::values() const noexcept
+{
+  return d_values;
+}
+
+template <typename T, typename E>
+std::span<const std::uint64_t> result_array<T, E>::error_bits() const noexcept
+{
+  return d_bits;
+}
+
+template <typename T, typename E>
+std::span<const std::pair<std::size_t, E>> result_array<T, E>::errors() const noexcept
+{
+  return d_errors;
+}
+
+template <typename T, typename E>
+template <typename F>
+auto result_array<T, E>::map(F&& f) const -> result_array<std::decay_t<std::invoke_result_t<F&, const T&>>, E>
+{
+  using U = std::decay_t<std::invoke_result_t<F&, const T&>>;
+
+  result_array<U, E> out;
+  out.d_values.resize(d_values.size());
+  out.d_bits   = d_bits;
+  out.d_errors = d_errors;
+
+  const T* in  = d_values.data();
+  U*       dst = out.d_values.data();
+  for(std::size_t w = 0; w < d_bits.size(); ++w)
+  {
+    const auto first = w * word_bits;
+    const auto last  = std::min(first + word_bits, d_values.size());
+    if(d_bits[w] == 0)
+    {
+      for(auto i = first; i < last; ++i)
+      {
+        dst[i] = f(in[i]);
+      }
+    }
+    else
+    {
+      for(auto i = first; i < last; ++i)
+      {
+        if(!((d_bits[w] >> (i - first)) & 1))
+        {
+          dst[i] = f(in[i]);
+        }
+      }
+    }
+  }
+  return out;
+}
+
+template <typename T, typename E>
+template <typename F>
+void result_array<T, E>::for_each_ok(F&& f) const
+{
+  for(std::size_t w = 0; w < d_bits.size(); ++w)
+  {
+    const auto first = w * word_bits;
+    const auto last  = std::min(first + word_bits, d_values.size());
+    for(auto ok = ~d_bits[w]; ok != 0; ok &= ok - 1)
+    {
+      auto i = first + static_cast<std::size_t>(std::countr_zero(ok));
+      if(i >= last)
+      {
+        break;
+      }
+      f(i, d_values[i]);
+    }
+  }
+}
+
+template <typename T, typename E>
+std::vector<result<T, E>> result_array<T, E>::to_vector() const
+{
+  std::vector<result<T, E>> out;
+  out.reserve(size());
+  for(std::size_t i = 0; i < size(); ++i)
+  {
+    out.push_back((*this)[i]);
+  }
+  return out;
+}
+
+template <typename T, typename E>
+void result_array<T, E>::mark(std::size_t i) noexcept
+{
+  d_bits[i / word_bits] |= std::uint64_t(1) << (i % word_bits);
+}
+
+template <typename T, typename E>
+const E* result_array<T, E>::find_error(std::size_t i) const noexcept
+{
+  auto it = std::lower_bound(d_errors.begin(), d_errors.end(), i, [](const auto& e, std::size_t idx) {
+    return e.first < idx;
+  });
+  return &it->second;
+}
+
+} // namespace results
@@ -0,0 +1,422 @@
+#pragma once
+
+#include "result.hh"
+#include "thread_pool.hh"
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <stop_token>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace results {
+
+// the error of a retry_executor call that ran out of time
+struct deadline_exceeded
+{
+};
+
+constexpr bool operator==(deadline_exceeded, deadline_exceeded) noexcept
+{
+  return true;
+}
+
+constexpr bool operator!=(deadline_exceeded, deadline_exceeded) noexcept
+{
+  return false;
+}
+
+// the error of a retry_executor call whose pool no longer takes tasks
+struct pool_closed
+{
+};
+
+constexpr bool operator==(pool_closed, pool_closed) noexcept
+{
+  return true;
+}
+
+constexpr bool operator!=(pool_closed, pool_closed) noexcept
+{
+  return false;
+}
+
+struct retry_policy
+{
+  std::size_t              max_attempts    = 3; // hedges included
+  std::chrono::nanoseconds initial_backoff = std::chrono::milliseconds(10);
+  std::chrono::nanoseconds max_backoff     = std::chrono::seconds(1);
+  double                   multiplier      = 2;
+  double                   jitter          = 0.5; // each backoff is drawn from [(1 - jitter) * backoff, backoff]
+  std::chrono::nanoseconds hedge_after     = std::chrono::nanoseconds::zero(); // zero disables hedging
+  std::chrono::nanoseconds deadline        = std::chrono::nanoseconds::max();
+};
+
+// Counters over all attempts of an executor. Attempts still running when their call returned, because another
+// attempt succeeded or the deadline passed, are counted as abandoned when they finish.
+struct attempt_stats
+{
+  static constexpr std::size_t buckets = 64;
+
+  std::uint64_t attempts  = 0;
+  std::uint64_t ok        = 0;
+  std::uint64_t err       = 0;
+  std::uint64_t abandoned = 0;
+  std::uint64_t retries   = 0;
+  std::uint64_t hedges    = 0;
+
+  std::chrono::nanoseconds           total_latency{0};
+  std::chrono::nanoseconds           max_latency{0};
+  std::array<std::uint64_t, buckets> histogram{}; // finished attempts by floor(log2(latency in ns))
+
+  // upper bound of the latency of the fraction p of the finished attempts, rounded up to a power of two
+  std::chrono::nanoseconds percentile(double p) const noexcept;
+
+  void record(std::chrono::nanoseconds latency, bool ok, bool abandoned) noexcept;
+};
+
+namespace internal {
+
+template <typename Clock, typename = void>
+constexpr bool has_wait_until_v = false;
+
+template <typename Clock>
+constexpr bool has_wait_until_v<Clock,
+                                 std::void_t<decltype(Clock::wait_until(std::declval<std::condition_variable&>(),
+                                                                        std::declval<std::unique_lock<std::mutex>&>(),
+                                                                        Clock::now()))>> = true;
+
+// block on cv until tp; clocks that do not follow real time (fake clocks in tests) provide their own wait_until
+template <typename Clock>
+void wait_until(std::condition_variable& cv, std::unique_lock<std::mutex>& lock, typename Clock::time_point tp)
+{
+  if constexpr(has_wait_until_v<Clock>)
+  {
+    Clock::wait_until(cv, lock, tp);
+  }
+  else if(tp == Clock::time_point::max())
+  {
+    // callers re-check their state after every wakeup, a long timed wait does for an unbounded one
+    cv.wait_for(lock, std::chrono::hours(1));
+  }
+  else
+  {
+    cv.wait_until(lock, tp);
+  }
+}
+
+// f() may take a std::stop_token, which is signalled once the call no longer needs the attempt
+template <typename F>
+decltype(auto) invoke_attempt(F& f, std::stop_token token)
+{
+  if constexpr(std::is_invocable_v<F&, std::stop_token>)
+  {
+    return std::invoke(f, std::move(token));
+  }
+  else
+  {
+    return std::invoke(f);
+  }
+}
+
+template <typename F>
+using attempt_result_t = std::decay_t<decltype(invoke_attempt(std::declval<F&>(), std::stop_token()))>;
+
+template <typename F, typename R = attempt_result_t<F>>
+using retry_result_t = result<typename R::value_type, typename R::error_type, deadline_exceeded, pool_closed>;
+
+// state shared between a call and its attempts, which may outlive the call
+template <typename F, typename T, typename E>
+struct retry_call
+{
+  explicit retry_call(F&& fn)
+    : f(std::move(fn))
+  {
+  }
+
+  F                       f;
+  std::mutex              mutex;
+  std::condition_variable cv;
+  std::stop_source        stop;
+  std::size_t             outstanding = 0;
+  bool                    done        = false;
+  std::optional<T>        value;
+  std::vector<E>          failures;  // in completion order, not yet looked at by the call
+  std::exception_ptr      exception; // of the first attempt that threw
+};
+
+} // namespace internal
+
+// Runs calls returning result<T, E> on a thread pool with retries, hedging and a deadline:
+// - a failed attempt is retried after a jittered exponential backoff if retryable(error) holds,
+// - while an attempt is outstanding for longer than hedge_after, another one is started; the first ok wins,
+// - once the deadline passes, the call returns deadline_exceeded.
+// An attempt that throws is not retried: the call rethrows its exception. A call whose attempt the pool refuses, after
+// thread_pool::shutdown(), returns pool_closed.
+// Outstanding attempts are signalled through their std::stop_token as soon as the call returns. The callable is shared
+// by concurrent attempts. Clock defaults to the steady clock; clocks providing a static
+// wait_until(condition_variable&, unique_lock<mutex>&, time_point) can be driven by tests.
+template <typename Clock = std::chrono::steady_clock>
+class retry_executor
+{
+public:
+  explicit retry_executor(thread_pool& pool, const retry_policy& policy = {}, std::uint64_t seed = std::random_device{}());
+
+  template <typename F, typename P>
+  auto run(F&& f, P&& retryable) -> internal::retry_result_t<std::decay_t<F>>;
+
+  const retry_policy& policy() const noexcept;
+
+  attempt_stats stats() const;
+
+private:
+  using time_point = typename Clock::time_point;
+
+  struct shared_stats
+  {
+    std::mutex    mutex;
+    attempt_stats stats;
+  };
+
+  // false if the pool refused the attempt
+  template <typename Call>
+  bool launch(const std::shared_ptr<Call>& call, std::unique_lock<std::mutex>& lock);
+
+  std::chrono::nanoseconds jittered(std::chrono::nanoseconds backoff);
+
+  static time_point after(time_point t, std::chrono::nanoseconds d) noexcept;
+
+  thread_pool&                  d_pool;
+  retry_policy                  d_policy;
+  std::shared_ptr<shared_stats> d_stats;
+  std::mutex                    d_rng_mutex;
+  std::mt19937_64               d_rng;
+};
+
+template <typename Clock>
+retry_executor<Clock>::retry_executor(thread_pool& pool, const retry_policy& policy, std::uint64_t seed)
+  : d_pool(pool)
+  , d_policy(policy)
+  , d_stats(std::make_shared<shared_stats>())
+  , d_rng(seed)
+{
+}
+
+template <typename Clock>
+template <typename F, typename P>
+auto retry_executor<Clock>::run(F&& f, P&& retryable) -> internal::retry_result_t<std::decay_t<F>>
+{
+  using R = internal::attempt_result_t<std::decay_t<F>>;
+  using T = typename R::value_type;
+  using E = typename R::error_type;
+  using U = internal::retry_result_t<std::decay_t<F>>;
+  static_assert(std::is_same_v<R, result<T, E>>, "attempts must return a result with a single error type");
+
+  auto call = std::make_shared<internal::retry_call<std::decay_t<F>, T, E>>(std::decay_t<F>(std::forward<F>(f)));
+
+  const auto start    = Clock::now();
+  const auto deadline = after(start, d_policy.deadline);
+  const bool hedging  = d_policy.hedge_after > std::chrono::nanoseconds::zero();
+
+  std::size_t      launched = 0;
+  auto             backoff  = d_policy.initial_backoff;
+  std::optional<E> last_error;
+  auto             next_retry = std::optional<time_point>(start);
+  auto             next_hedge = time_point::max();
+
+  std::unique_lock<std::mutex> lock(call->mutex);
+  auto abandon = [&] {
+    call->done = true;
+    call->stop.request_stop();
+  };
+  auto finish = [&](U outcome) {
+    abandon();
+    return outcome;
+  };
+
+  for(;;)
+  {
+    if(call->value)
+    {
+      return finish(U::ok(std::move(*call->value)));
+    }
+
+    if(call->exception)
+    {
+      abandon();
+      std::rethrow_exception(call->exception);
+    }
+
+    for(auto& e : call->failures)
+    {
+      if(!retryable(std::as_const(e)))
+      {
+        return finish(U::err(std::move(e)));
+      }
+      last_error = std::move(e);
+    }
+    call->failures.clear();
+
+    auto now = Clock::now();
+    if(call->outstanding == 0 && !next_retry)
+    {
+      // every attempt so far failed with a retryable error
+      if(launched >= d_policy.max_attempts)
+      {
+        return finish(U::err(std::move(*last_error)));
+      }
+      next_retry = after(now, jittered(backoff));
+      backoff    = std::min(std::chrono::duration_cast<std::chrono::nanoseconds>(backoff * d_policy.multiplier), d_policy.max_backoff);
+    }
+
+    if(now >= deadline)
+    {
+      return finish(U::err(deadline_exceeded{}));
+    }
+
+    if(next_retry && now >= *next_retry)
+    {
+      if(launched > 0)
+      {
+        std::lock_guard<std::mutex> stats_lock(d_stats->mutex);
+        ++d_stats->stats.retries;
+      }
+      next_retry.reset();
+      if(!launch(call, lock))
+      {
+        return finish(U::err(pool_closed{}));
+      }
+      ++launched;
+      next_hedge = hedging ? after(now, d_policy.hedge_after) : time_point::max();
+      continue;
+    }
+
+    if(!next_retry && call->outstanding > 0 && now >= next_hedge && launched < d_policy.max_attempts)
+    {
+      {
+        std::lock_guard<std::mutex> stats_lock(d_stats->mutex);
+        ++d_stats->stats.hedges;
+      }
+      if(!launch(call, lock))
+      {
+        return finish(U::err(pool_closed{}));
+      }
+      ++launched;
+      next_hedge = after(now, d_policy.hedge_after);
+      continue;
+    }
+
+    auto wake = std::min(deadline, next_retry ? *next_retry : time_point::max());
+    if(!next_retry && call->outstanding > 0 && launched < d_policy.max_attempts)
+    {
+      wake = std::min(wake, next_hedge);
+    }
+    internal::wait_until<Clock>(call->cv, lock, wake);
+  }
+}
+
+template <typename Clock>
+template <typename Call>
+bool retry_executor<Clock>::launch(const std::shared_ptr<Call>& call, std::unique_lock<std::mutex>& lock)
+{
+  ++call->outstanding;
+
+  auto attempt = [call, stats = d_stats] {
+    using R = internal::attempt_result_t<decltype(call->f)>;
+
+    // a throw must not escape into the worker, it is handed to the call instead
+    auto               start = Clock::now();
+    std::optional<R>   outcome;
+    std::exception_ptr thrown;
+    try
+    {
+      outcome.emplace(internal::invoke_attempt(call->f, call->stop.get_token()));
+    }
+    catch(...)
+    {
+      thrown = std::current_exception();
+    }
+    auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start);
+
+    std::lock_guard<std::mutex> lock(call->mutex);
+    --call->outstanding;
+    {
+      std::lock_guard<std::mutex> stats_lock(stats->mutex);
+      stats->stats.record(latency, outcome && outcome->is_ok(), call->done);
+    }
+    if(!call->done)
+    {
+      if(thrown)
+      {
+        if(!call->exception)
+        {
+          call->exception = std::move(thrown);
+        }
+      }
+      else if(outcome->is_ok())
+      {
+        call->value.emplace(std::get<0>(std::move(*outcome).as_variant()));
+      }
+      else
+      {
+        call->failures.push_back(std::get<1>(std::move(*outcome).as_variant()));
+      }
+      call->cv.notify_all();
+    }
+  };
+
+  // workers need the call's mutex to finish, do not hold it while the pool's queue may be full
+  lock.unlock();
+  const bool submitted = d_pool.submit(std::move(attempt));
+  lock.lock();
+
+  if(!submitted)
+  {
+    --call->outstanding;
+  }
+  return submitted;
+}
+
+template <typename Clock>
+const retry_policy& retry_executor<Clock>::policy() const noexcept
+{
+  return d_policy;
+}
+
+template <typename Clock>
+attempt_stats retry_executor<Clock>::stats() const
+{
+  std::lock_guard<std::mutex> lock(d_stats->mutex);
+  return d_stats->stats;
+}
+
+template <typename Clock>
+std::chrono::nanoseconds retry_executor<Clock>::jittered(std::chrono::nanoseconds backoff)
+{
+  std::uniform_real_distribution<double> factor(1 - d_policy.jitter, 1);
+
+  std::lock_guard<std::mutex> lock(d_rng_mutex);
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(backoff * factor(d_rng));
+}
+
+template <typename Clock>
+auto retry_executor<Clock>::after(time_point t, std::chrono::nanoseconds d) noexcept -> time_point
+{
+  // saturate instead of overflowing for the default, unlimited deadline
+  if(t == time_point::max() || d >= std::chrono::duration_cast<std::chrono::nanoseconds>(time_point::max() - t))
+  {
+    return time_point::max();
+  }
+  return t + std::chrono::duration_cast<typename Clock::duration>(d);
+}
+
+} // namespace results
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "channel.hh"
+#include <cstddef>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace results {
+
+// Fixed set of worker threads taking tasks from a bounded channel. shutdown(), or else the destructor, lets the workers
+// finish the queued tasks and joins them.
+class thread_pool
+{
+public:
+  explicit thread_pool(std::size_t threads, std::size_t queue_capacity = 1024);
+
+  thread_pool(const thread_pool&) = delete;
+  thread_pool& operator=(const thread_pool&) = delete;
+
+  ~thread_pool();
+
+  std::size_t size() const noexcept;
+
+  // blocks while the queue is full, fails once the pool is shutting down
+  bool submit(std::function<void()> task);
+
+  // refuses further tasks and returns once the queued ones are done; only the first call waits, not from a worker
+  void shutdown();
+
+private:
+  void work();
+
+  channel<std::function<void()>> d_tasks;
+  std::vector<std::thread>       d_workers;
+};
+
+} // namespace results
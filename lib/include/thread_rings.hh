@@ -0,0 +1,205 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace results {
+namespace internal {
+
+// Per-thread ring buffers of the most recent events, behind the flight recorder and the tracer. A thread writes its
+// own ring without locking; a slot's sequence is odd while a write is in progress and readers skip slots that changed
+// while they copied them. Payload holds the fields as relaxed atomics, so that such races stay well defined, and
+// provides load(), which copies them into a plain Payload::snapshot. The rings of exited threads are folded into a
+// bounded list of retired entries. Every Payload type gets its own set of rings.
+template <typename Payload, std::size_t Capacity>
+class thread_rings
+{
+  static_assert(std::has_single_bit(Capacity), "the capacity must be a power of two");
+
+public:
+  using snapshot = typename Payload::snapshot;
+
+  static constexpr std::size_t capacity         = Capacity;
+  static constexpr std::size_t retired_capacity = 4 * Capacity;
+
+  struct entry
+  {
+    snapshot      value;
+    std::uint32_t thread; // threads are numbered in the order of their first write
+  };
+
+  // store(payload) fills the next slot of the calling thread's ring with relaxed stores
+  template <typename F>
+  static void write(F&& store) noexcept;
+
+  // the entries of live and exited threads, those of each thread oldest first
+  static std::vector<entry> collect();
+
+  // forget the entries of exited threads
+  static void clear_retired();
+
+private:
+  struct slot_fields
+  {
+    std::atomic<std::uint64_t> sequence{0};
+    Payload                    payload;
+  };
+
+  struct alignas(std::min<std::size_t>(64, std::bit_ceil(sizeof(slot_fields)))) slot : slot_fields
+  {
+  };
+
+  struct alignas(64) ring
+  {
+    explicit ring(std::uint32_t t) noexcept
+      : thread(t)
+    {
+    }
+
+    std::array<slot, Capacity> slots;
+    std::atomic<std::uint64_t> written{0};
+    const std::uint32_t        thread;
+  };
+
+  struct registry
+  {
+    std::mutex         mutex;
+    std::vector<ring*> live;
+    std::deque<entry>  retired;
+    std::uint32_t      threads = 0;
+  };
+
+  // registers the thread's ring on first use, retires its entries when the thread exits
+  class registration
+  {
+  public:
+    ring& buffer();
+
+    ~registration();
+
+  private:
+    std::unique_ptr<ring> d_ring;
+  };
+
+  static registry& global();
+
+  static void collect(const ring& r, std::vector<entry>& out);
+
+  static inline thread_local registration s_thread;
+};
+
+template <typename Payload, std::size_t Capacity>
+template <typename F>
+void thread_rings<Payload, Capacity>::write(F&& store) noexcept
+{
+  auto& r = s_thread.buffer();
+
+  auto  n        = r.written.load(std::memory_order_relaxed);
+  auto& s        = r.slots[n & (Capacity - 1)];
+  auto  sequence = s.sequence.load(std::memory_order_relaxed);
+  s.sequence.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  store(s.payload);
+
+  s.sequence.store(sequence + 2, std::memory_order_release);
+  r.written.store(n + 1, std::memory_order_release);
+}
+
+template <typename Payload, std::size_t Capacity>
+auto thread_rings<Payload, Capacity>::collect() -> std::vector<entry>
+{
+  auto&                       r = global();
+  std::lock_guard<std::mutex> lock(r.mutex);
+
+  std::vector<entry> out(r.retired.begin(), r.retired.end());
+  for(const auto* live : r.live)
+  {
+    collect(*live, out);
+  }
+  return out;
+}
+
+template <typename Payload, std::size_t Capacity>
+void thread_rings<Payload, Capacity>::clear_retired()
+{
+  auto&                       r = global();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  r.retired.clear();
+}
+
+template <typename Payload, std::size_t Capacity>
+auto thread_rings<Payload, Capacity>::global() -> registry&
+{
+  static auto* r = new registry; // never destroyed, threads may exit after static destruction
+  return *r;
+}
+
+template <typename Payload, std::size_t Capacity>
+void thread_rings<Payload, Capacity>::collect(const ring& r, std::vector<entry>& out)
+{
+  auto written = r.written.load(std::memory_order_acquire);
+  auto first   = written > Capacity ? written - Capacity : 0;
+  for(auto i = first; i < written; ++i)
+  {
+    const auto& s      = r.slots[i & (Capacity - 1)];
+    auto        before = s.sequence.load(std::memory_order_acquire);
+    if(before & 1)
+    {
+      continue;
+    }
+    auto value = s.payload.load();
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if(s.sequence.load(std::memory_order_relaxed) != before)
+    {
+      continue;
+    }
+    out.push_back({std::move(value), r.thread});
+  }
+}
+
+template <typename Payload, std::size_t Capacity>
+auto thread_rings<Payload, Capacity>::registration::buffer() -> ring&
+{
+  if(!d_ring)
+  {
+    auto&                       r = global();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    d_ring = std::make_unique<ring>(r.threads++);
+    r.live.push_back(d_ring.get());
+  }
+  return *d_ring;
+}
+
+template <typename Payload, std::size_t Capacity>
+thread_rings<Payload, Capacity>::registration::~registration()
+{
+  if(!d_ring)
+  {
+    return;
+  }
+
+  auto&                       r = global();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  r.live.erase(std::find(r.live.begin(), r.live.end(), d_ring.get()));
+
+  std::vector<entry> entries;
+  collect(*d_ring, entries);
+  r.retired.insert(r.retired.end(), std::make_move_iterator(entries.begin()), std::make_move_iterator(entries.end()));
+  while(r.retired.size() > retired_capacity)
+  {
+    r.retired.pop_front();
+  }
+}
+
+} // namespace internal
+} // namespace results
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace results {
+namespace internal {
+
+// Raw timestamp for the recorder and the tracer: the time stamp counter where there is one, it is an order of
+// magnitude cheaper than reading the steady clock and constant rate on every x86 processor of the last decade.
+inline std::uint64_t timestamp() noexcept
+{
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+// Maps timestamps to steady clock nanoseconds, at a rate measured between the library load and construction; one
+// converter keeps a batch of timestamps in order
+class timestamp_converter
+{
+public:
+  timestamp_converter() noexcept;
+
+  std::uint64_t to_ns(std::uint64_t t) const noexcept;
+
+private:
+  double d_rate;
+};
+
+} // namespace internal
+} // namespace results
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "io.hh"
+#include "result.hh"
+#include "timestamp.hh"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <iosfwd>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Tracing spans over result chains (RESULTS_TRACE). A trace_span times a scope and the outcome of the result it
+// produced; traced() wraps a step of an and_then()/map() chain in one. Each finished span leaves an event in a
+// per-thread ring buffer that keeps the most recent ones, export_chrome_trace() writes them all as Chrome trace-event
+// JSON, to be opened in chrome://tracing or Perfetto. Without RESULTS_TRACE, trace_span is an empty type and traced()
+// hands back the function it was given, so that spans can stay in the code.
+
+namespace results {
+
+enum class span_outcome : std::uint8_t {
+  none, // the span did not produce a result
+  ok,
+  err,
+};
+
+struct trace_event
+{
+  std::string_view name;     // a static string of the program
+  std::uint64_t    start;    // nanoseconds on the steady clock
+  std::uint64_t    duration; // nanoseconds
+  std::uint32_t    thread;   // threads are numbered in the order of their first span
+  span_outcome     outcome;
+};
+
+// the events of all threads, including exited ones, by start; empty unless tracing is compiled in
+std::vector<trace_event> snapshot_trace();
+
+// leave out everything traced so far from later snapshots
+void clear_trace();
+
+// the snapshot as a Chrome trace-event JSON object
+void write_chrome_trace(std::ostream& out);
+
+// write_chrome_trace() into a file, replacing it; the number of bytes written
+result<std::size_t, io::sys_error> export_chrome_trace(const std::filesystem::path& path);
+
+template <typename R>
+constexpr span_outcome outcome_of(const R& r) noexcept
+{
+  if constexpr(internal::is_result_v<R>)
+  {
+    return r.is_ok() ? span_outcome::ok : span_outcome::err;
+  }
+  else
+  {
+    return span_outcome::none;
+  }
+}
+
+namespace internal {
+
+// appends a finished span to the calling thread's ring buffer; start and end are raw timestamps
+void record_span(const char* name, std::uint64_t start, std::uint64_t end, span_outcome outcome) noexcept;
+
+} // namespace internal
+
+// Times its scope, from construction to destruction
+class trace_span
+{
+public:
+  // name must outlive the trace, typically a string literal
+  explicit trace_span(const char* name) noexcept;
+
+  ~trace_span();
+
+  trace_span(const trace_span&) = delete;
+
+  trace_span& operator=(const trace_span&) = delete;
+
+  void set_outcome(span_outcome outcome) noexcept;
+
+private:
+#ifdef RESULTS_TRACE
+  const char*   d_name;
+  std::uint64_t d_start;
+  span_outcome  d_outcome = span_outcome::none;
+#endif
+};
+
+// f wrapped in a span named name, e.g. r.and_then(traced("parse", parse)); the outcome is taken from the result f
+// returns
+template <typename F>
+constexpr auto traced(const char* name, F&& f)
+{
+#ifdef RESULTS_TRACE
+  return [name, f = std::forward<F>(f)](auto&&... args) mutable -> decltype(auto) {
+    trace_span span(name);
+    if constexpr(std::is_void_v<std::invoke_result_t<std::decay_t<F>&, decltype(args)...>>)
+    {
+      std::invoke(f, std::forward<decltype(args)>(args)...);
+    }
+    else
+    {
+      decltype(auto) r = std::invoke(f, std::forward<decltype(args)>(args)...);
+      span.set_outcome(outcome_of(r));
+      return r;
+    }
+  };
+#else
+  (void)name;
+  return std::forward<F>(f);
+#endif
+}
+
+inline trace_span::trace_span(const char* name) noexcept
+#ifdef RESULTS_TRACE
+  : d_name(name)
+  , d_start(internal::timestamp())
+#endif
+{
+  (void)name;
+}
+
+inline trace_span::~trace_span()
+{
+#ifdef RESULTS_TRACE
+  internal::record_span(d_name, d_start, internal::timestamp(), d_outcome);
+#endif
+}
+
+inline void trace_span::set_outcome(span_outcome outcome) noexcept
+{
+#ifdef RESULTS_TRACE
+  d_outcome = outcome;
+#else
+  (void)outcome;
+#endif
+}
+
+} // namespace results
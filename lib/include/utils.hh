@@ -1,10 +1,32 @@
 #pragma once
 
+#include "backtrace.hh"
+#include "instrument.hh"
+#include "recorder.hh"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <type_traits>
 #include <stdexcept>
 #include <string>
 #include <string_view>
 
+// unwrap_unchecked() and friends verify their precondition and panic in debug and sanitizer builds
+#ifndef RESULTS_VERIFY_UNCHECKED
+#if !defined(NDEBUG) || defined(__SANITIZE_ADDRESS__) || defined(__SANITIZE_THREAD__)
+#define RESULTS_VERIFY_UNCHECKED 1
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer) || __has_feature(thread_sanitizer) || __has_feature(memory_sanitizer)
+#define RESULTS_VERIFY_UNCHECKED 1
+#endif
+#endif
+#endif
+
+#ifndef RESULTS_VERIFY_UNCHECKED
+#define RESULTS_VERIFY_UNCHECKED 0
+#endif
+
 namespace results {
 
 class panicked : public std::exception
@@ -12,18 +34,161 @@ class panicked : public std::exception
 public:
   explicit panicked(std::string_view msg);
 
+  panicked(std::string_view msg, const backtrace& trace);
+
   const char* what() const noexcept;
 
+  // the stack at the point of panicking, empty unless backtrace sampling is enabled
+  const backtrace& trace() const noexcept;
+
 private:
   std::string d_msg;
+  backtrace   d_trace;
 };
 
 namespace internal {
 
-[[noreturn]] void panic(std::string_view msg);
+// counted per call site when instrumentation is compiled in
+[[noreturn]] void panic(std::string_view msg, const call_site& site = call_site::current());
+
+// Precondition of the unchecked accessors: panics when RESULTS_VERIFY_UNCHECKED is set, otherwise lets the optimizer
+// assume cond holds.
+constexpr void assume(bool cond, std::string_view msg)
+{
+#if RESULTS_VERIFY_UNCHECKED
+  if(!cond)
+  {
+    panic(msg);
+  }
+#else
+  (void)msg;
+  if(!cond)
+  {
+    __builtin_unreachable();
+  }
+#endif
+}
+
+// T tells the allocator it was built with through get_allocator()
+template <typename T, typename = void>
+constexpr bool has_allocator_v = false;
+
+template <typename T>
+constexpr bool has_allocator_v<T, std::void_t<decltype(std::declval<const T&>().get_allocator())>> =
+    std::uses_allocator_v<T, decltype(std::declval<const T&>().get_allocator())>;
+
+// Uses-allocator construction: calls construct() with the arguments T needs to be built with alloc, following the
+// leading std::allocator_arg or trailing allocator conventions. Types that do not use alloc get args unchanged.
+template <typename T, typename F, typename Alloc, typename... Args>
+constexpr auto construct_using_allocator(F&& construct, const Alloc& alloc, Args&&... args)
+{
+  if constexpr(!std::uses_allocator_v<T, Alloc>)
+  {
+    return construct(std::forward<Args>(args)...);
+  }
+  else if constexpr(std::is_constructible_v<T, std::allocator_arg_t, const Alloc&, Args...>)
+  {
+    return construct(std::allocator_arg, alloc, std::forward<Args>(args)...);
+  }
+  else
+  {
+    static_assert(std::is_constructible_v<T, Args..., const Alloc&>, "T uses an allocator but cannot be constructed with one");
+    return construct(std::forward<Args>(args)..., alloc);
+  }
+}
+
+template <typename... Ts>
+struct type_list
+{
+};
+
+// index of the first X in Ts, sizeof...(Ts) if there is none
+template <typename X, typename... Ts>
+struct index_of : std::integral_constant<std::size_t, 0>
+{
+};
+
+template <typename X, typename T, typename... Ts>
+struct index_of<X, T, Ts...>
+  : std::integral_constant<std::size_t, std::is_same_v<X, T> ? 0 : 1 + index_of<X, Ts...>::value>
+{
+};
+
+template <typename X, typename... Ts>
+constexpr std::size_t index_of_v = index_of<X, Ts...>::value;
+
+template <typename X, typename... Ts>
+constexpr bool contains_v = index_of_v<X, Ts...> < sizeof...(Ts);
 
+// calls f(std::integral_constant<std::size_t, idx>{}) for a runtime idx in [I, Last)
+template <typename R, std::size_t I, std::size_t Last, typename F>
+constexpr R visit_index(std::size_t idx, F&& f)
+{
+  if constexpr(I + 1 == Last)
+  {
+    (void)idx;
+    return f(std::integral_constant<std::size_t, I>{});
+  }
+  else
+  {
+    if(idx == I)
+    {
+      return f(std::integral_constant<std::size_t, I>{});
+    }
+    return visit_index<R, I + 1, Last>(idx, f);
+  }
+}
+
+// the splitmix64 finalizer, every input bit affects every output bit
+constexpr std::uint64_t mix64(std::uint64_t x) noexcept
+{
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ull;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebull;
+  x ^= x >> 31;
+  return x;
 }
 
+// std::hash<T> is enabled
+template <typename T>
+constexpr bool is_hashable_v = std::is_default_constructible_v<std::hash<T>> && std::is_invocable_r_v<std::size_t, const std::hash<T>&, const T&>;
+
+// Hash of a payload with its discriminant folded in. Integers, enums and pointers skip std::hash and are mixed directly.
+template <typename T>
+std::size_t hash_with_tag(const T& value, std::size_t tag) noexcept
+{
+  std::size_t h;
+  if constexpr(std::is_integral_v<T> || std::is_enum_v<T>)
+  {
+    h = static_cast<std::size_t>(value);
+  }
+  else if constexpr(std::is_pointer_v<T>)
+  {
+    h = reinterpret_cast<std::size_t>(value);
+  }
+  else
+  {
+    h = std::hash<T>{}(value);
+  }
+  // both are mixed before they are combined: integer payloads hash to themselves, and xoring a small tag into them
+  // would map alternatives onto each other, e.g. ok(x) onto err(x ^ 2)
+  const auto payload = mix64(h);
+  return static_cast<std::size_t>(payload ^ (mix64(tag) + 0x9e3779b97f4a7c15ull + (payload << 6) + (payload >> 2)));
+}
+
+} // namespace internal
+
+// combine callables into one overload set, e.g. to handle every error type in result::match()
+template <typename... Fs>
+struct overloaded : Fs...
+{
+  using Fs::operator()...;
+};
+
+template <typename... Fs>
+overloaded(Fs...) -> overloaded<Fs...>;
+
 template <typename T>
 struct return_wrapper
 {
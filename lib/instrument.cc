@@ -0,0 +1,199 @@
+#include "instrument.hh"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
+namespace results {
+namespace internal {
+namespace {
+
+constexpr std::size_t cache_line_size = 64;
+
+// filled in by the owning thread only; file is published last so that other threads can read a slot without locking
+struct slot
+{
+  std::atomic<const char*>   file{nullptr};
+  const char*                function = nullptr;
+  std::uint_least32_t        line     = 0;
+  std::uint_least32_t        column   = 0;
+  site_kind                  kind     = site_kind::ok;
+  std::atomic<std::uint64_t> count{0};
+};
+
+// a thread's counters, on their own cache lines so that threads never share one
+struct alignas(cache_line_size) thread_counters
+{
+  static constexpr std::size_t capacity = 1024; // power of two
+
+  std::array<slot, capacity> slots;
+  std::atomic<std::uint64_t> dropped{0};
+};
+
+// sites are compared by content, the same file name may be stored more than once in the program
+using site_key  = std::tuple<std::string_view, std::string_view, std::uint_least32_t, std::uint_least32_t, site_kind>;
+using panic_key = std::tuple<std::string_view, std::string_view, std::uint_least32_t, std::uint_least32_t>;
+
+struct registry
+{
+  std::mutex                          mutex;
+  std::vector<thread_counters*>       live;
+  std::map<site_key, std::uint64_t>   retired;
+  std::uint64_t                       retired_dropped = 0;
+  std::map<panic_key, panic_count>    panics;
+};
+
+registry& global_registry()
+{
+  static auto* r = new registry; // never destroyed, threads may exit after static destruction
+  return *r;
+}
+
+void add(std::map<site_key, std::uint64_t>& totals, const slot& s)
+{
+  if(const char* file = s.file.load(std::memory_order_acquire))
+  {
+    totals[site_key{file, s.function, s.line, s.column, s.kind}] += s.count.load(std::memory_order_relaxed);
+  }
+}
+
+// registers the thread's counters on first use, folds them into the retired totals when the thread exits
+class thread_registration
+{
+public:
+  thread_counters& counters()
+  {
+    if(!d_counters)
+    {
+      d_counters = std::make_unique<thread_counters>();
+
+      auto&                       r = global_registry();
+      std::lock_guard<std::mutex> lock(r.mutex);
+      r.live.push_back(d_counters.get());
+    }
+    return *d_counters;
+  }
+
+  ~thread_registration()
+  {
+    if(!d_counters)
+    {
+      return;
+    }
+
+    auto&                       r = global_registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.live.erase(std::find(r.live.begin(), r.live.end(), d_counters.get()));
+    for(const auto& s : d_counters->slots)
+    {
+      add(r.retired, s);
+    }
+    r.retired_dropped += d_counters->dropped.load(std::memory_order_relaxed);
+  }
+
+private:
+  std::unique_ptr<thread_counters> d_counters;
+};
+
+thread_local thread_registration s_thread;
+
+std::size_t hash(const std::source_location& site, site_kind kind) noexcept
+{
+  auto h = reinterpret_cast<std::uintptr_t>(site.file_name()) ^ (std::uintptr_t(site.line()) << 16) ^
+           (std::uintptr_t(site.column()) << 40) ^ std::uintptr_t(kind);
+  return static_cast<std::size_t>((h * 0x9e3779b97f4a7c15ull) >> 32);
+}
+
+template <typename T>
+bool by_count(const T& lhs, const T& rhs) noexcept
+{
+  return lhs.count > rhs.count;
+}
+
+} // namespace
+
+void count_site(site_kind kind, const std::source_location& site) noexcept
+{
+  auto& counters = s_thread.counters();
+
+  auto idx = hash(site, kind);
+  for(std::size_t probe = 0; probe < thread_counters::capacity; ++probe, ++idx)
+  {
+    auto& s    = counters.slots[idx & (thread_counters::capacity - 1)];
+    auto* file = s.file.load(std::memory_order_relaxed);
+    if(file == nullptr)
+    {
+      s.function = site.function_name();
+      s.line     = site.line();
+      s.column   = site.column();
+      s.kind     = kind;
+      s.count.store(1, std::memory_order_relaxed);
+      s.file.store(site.file_name(), std::memory_order_release);
+      return;
+    }
+    if(file == site.file_name() && s.line == site.line() && s.column == site.column() && s.kind == kind)
+    {
+      // only this thread writes, a plain increment is enough
+      s.count.store(s.count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+      return;
+    }
+  }
+  counters.dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+void count_panic(std::string_view msg, const std::source_location& site)
+{
+  auto&                       r = global_registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+
+  auto& p = r.panics[panic_key{site.file_name(), site.function_name(), site.line(), site.column()}];
+  if(p.count++ == 0)
+  {
+    p.file     = site.file_name();
+    p.function = site.function_name();
+    p.line     = site.line();
+    p.column   = site.column();
+  }
+  p.message.assign(msg);
+}
+
+} // namespace internal
+
+instrumentation_snapshot snapshot_instrumentation()
+{
+  auto&                       r = internal::global_registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+
+  auto totals  = r.retired;
+  auto dropped = r.retired_dropped;
+  for(const auto* counters : r.live)
+  {
+    for(const auto& s : counters->slots)
+    {
+      internal::add(totals, s);
+    }
+    dropped += counters->dropped.load(std::memory_order_relaxed);
+  }
+
+  instrumentation_snapshot snapshot{{}, {}, dropped};
+  snapshot.sites.reserve(totals.size());
+  for(const auto& [key, count] : totals)
+  {
+    const auto& [file, function, line, column, kind] = key;
+    snapshot.sites.push_back(site_count{file, function, line, column, kind, count});
+  }
+  for(const auto& [key, p] : r.panics)
+  {
+    snapshot.panics.push_back(p);
+  }
+
+  std::stable_sort(snapshot.sites.begin(), snapshot.sites.end(), internal::by_count<site_count>);
+  std::stable_sort(snapshot.panics.begin(), snapshot.panics.end(), internal::by_count<panic_count>);
+  return snapshot;
+}
+
+} // namespace results
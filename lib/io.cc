@@ -0,0 +1,301 @@
+#include "io.hh"
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace results {
+namespace io {
+namespace {
+
+struct close_dir
+{
+  void operator()(DIR* d) const noexcept
+  {
+    ::closedir(d);
+  }
+};
+
+entry_type type_of(const dirent& e) noexcept
+{
+#ifdef _DIRENT_HAVE_D_TYPE
+  switch(e.d_type)
+  {
+  case DT_REG:
+    return entry_type::file;
+  case DT_DIR:
+    return entry_type::directory;
+  case DT_LNK:
+    return entry_type::symlink;
+  case DT_UNKNOWN:
+    return entry_type::unknown;
+  default:
+    return entry_type::other;
+  }
+#else
+  (void)e;
+  return entry_type::unknown;
+#endif
+}
+
+} // namespace
+
+std::string sys_error::message() const
+{
+  return std::string(operation) + ": " + std::system_category().message(code);
+}
+
+std::error_code sys_error::error_code() const noexcept
+{
+  return std::error_code(code, std::system_category());
+}
+
+bool operator==(const sys_error& lhs, const sys_error& rhs) noexcept
+{
+  return lhs.code == rhs.code && std::strcmp(lhs.operation, rhs.operation) == 0;
+}
+
+bool operator!=(const sys_error& lhs, const sys_error& rhs) noexcept
+{
+  return !(lhs == rhs);
+}
+
+sys_error last_error(const char* operation) noexcept
+{
+  return sys_error{errno, operation};
+}
+
+result<file, sys_error> file::open(const std::filesystem::path& path)
+{
+  int fd;
+  do
+  {
+    fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  } while(fd < 0 && errno == EINTR);
+
+  if(fd < 0)
+  {
+    return result<file, sys_error>::err(last_error("open"));
+  }
+  return result<file, sys_error>::ok(file(fd));
+}
+
+file::file(int fd) noexcept
+  : d_fd(fd)
+{
+}
+
+file::file(file&& other) noexcept
+  : d_fd(other.d_fd)
+{
+  other.d_fd = -1;
+}
+
+file& file::operator=(file&& other) noexcept
+{
+  if(this != &other)
+  {
+    if(d_fd >= 0)
+    {
+      ::close(d_fd);
+    }
+    d_fd       = other.d_fd;
+    other.d_fd = -1;
+  }
+  return *this;
+}
+
+file::~file()
+{
+  if(d_fd >= 0)
+  {
+    ::close(d_fd);
+  }
+}
+
+int file::fd() const noexcept
+{
+  return d_fd;
+}
+
+result<std::uint64_t, sys_error> file::size() const
+{
+  struct stat st;
+  if(::fstat(d_fd, &st) != 0)
+  {
+    return result<std::uint64_t, sys_error>::err(last_error("fstat"));
+  }
+  return result<std::uint64_t, sys_error>::ok(static_cast<std::uint64_t>(st.st_size));
+}
+
+mapped_view::mapped_view() noexcept
+  : d_addr(nullptr)
+  , d_size(0)
+{
+}
+
+mapped_view::mapped_view(void* addr, std::size_t size) noexcept
+  : d_addr(addr)
+  , d_size(size)
+{
+}
+
+mapped_view::mapped_view(mapped_view&& other) noexcept
+  : d_addr(other.d_addr)
+  , d_size(other.d_size)
+{
+  other.d_addr = nullptr;
+  other.d_size = 0;
+}
+
+mapped_view& mapped_view::operator=(mapped_view&& other) noexcept
+{
+  if(this != &other)
+  {
+    if(d_addr)
+    {
+      ::munmap(d_addr, d_size);
+    }
+    d_addr       = other.d_addr;
+    d_size       = other.d_size;
+    other.d_addr = nullptr;
+    other.d_size = 0;
+  }
+  return *this;
+}
+
+mapped_view::~mapped_view()
+{
+  if(d_addr)
+  {
+    ::munmap(d_addr, d_size);
+  }
+}
+
+const std::byte* mapped_view::data() const noexcept
+{
+  return static_cast<const std::byte*>(d_addr);
+}
+
+std::size_t mapped_view::size() const noexcept
+{
+  return d_size;
+}
+
+bool mapped_view::empty() const noexcept
+{
+  return d_size == 0;
+}
+
+std::span<const std::byte> mapped_view::bytes() const noexcept
+{
+  return std::span<const std::byte>(data(), d_size);
+}
+
+std::string_view mapped_view::text() const noexcept
+{
+  return std::string_view(static_cast<const char*>(d_addr), d_size);
+}
+
+result<mapped_view, sys_error> map_file(const std::filesystem::path& path)
+{
+  using R = result<mapped_view, sys_error>;
+
+  auto f = file::open(path);
+  if(f.is_err())
+  {
+    return R::err(f.unwrap_err_unchecked());
+  }
+  auto size = f.unwrap_unchecked().size();
+  if(size.is_err())
+  {
+    return R::err(size.unwrap_err_unchecked());
+  }
+  if(size.unwrap_unchecked() == 0)
+  {
+    // mmap() rejects empty mappings
+    return R::ok(mapped_view());
+  }
+
+  auto length = static_cast<std::size_t>(size.unwrap_unchecked());
+  void* addr  = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, f.unwrap_unchecked().fd(), 0);
+  if(addr == MAP_FAILED)
+  {
+    return R::err(last_error("mmap"));
+  }
+  // the mapping keeps the file alive, the descriptor is closed on return
+  return R::ok(mapped_view(addr, length));
+}
+
+result<std::size_t, sys_error> read_at(int fd, std::span<std::byte> buffer, std::uint64_t offset)
+{
+  using R = result<std::size_t, sys_error>;
+
+  std::size_t done = 0;
+  while(done < buffer.size())
+  {
+    auto n = ::pread(fd, buffer.data() + done, buffer.size() - done, static_cast<off_t>(offset + done));
+    if(n < 0)
+    {
+      if(errno == EINTR)
+      {
+        continue;
+      }
+      return R::err(last_error("pread"));
+    }
+    if(n == 0)
+    {
+      break;
+    }
+    done += static_cast<std::size_t>(n);
+  }
+  return R::ok(done);
+}
+
+result<std::size_t, sys_error> read_at(const file& f, std::span<std::byte> buffer, std::uint64_t offset)
+{
+  return read_at(f.fd(), buffer, offset);
+}
+
+result_generator<directory_entry, sys_error> read_directory(std::filesystem::path dir)
+{
+  using R = result<directory_entry, sys_error>;
+
+  std::unique_ptr<DIR, close_dir> d(::opendir(dir.c_str()));
+  if(!d)
+  {
+    co_yield stop_with(last_error("opendir"));
+    co_return;
+  }
+
+  for(;;)
+  {
+    // readdir() signals the end and errors alike with nullptr, only errno tells them apart
+    errno           = 0;
+    const dirent* e = ::readdir(d.get());
+    if(!e)
+    {
+      if(errno != 0)
+      {
+        co_yield stop_with(last_error("readdir"));
+      }
+      co_return;
+    }
+
+    std::string_view name(e->d_name);
+    if(name == "." || name == "..")
+    {
+      continue;
+    }
+    // built outside of the co_yield expression, gcc 12 miscompiles aggregate temporaries in there
+    directory_entry entry{std::string(name), type_of(*e)};
+    co_yield R::ok(std::move(entry));
+  }
+}
+
+} // namespace io
+} // namespace results
@@ -0,0 +1,21 @@
+#include "parse.hh"
+
+namespace results {
+
+std::string_view parse_error::message() const noexcept
+{
+  switch(kind)
+  {
+  case parse_errc::empty:
+    return "empty input";
+  case parse_errc::invalid:
+    return "invalid input";
+  case parse_errc::out_of_range:
+    return "value out of range";
+  case parse_errc::trailing_characters:
+    return "trailing characters";
+  }
+  return "unknown parse error";
+}
+
+} // namespace results
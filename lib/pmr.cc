@@ -0,0 +1,41 @@
+#include "pmr.hh"
+
+namespace results {
+namespace pmr {
+
+error::error(std::string_view m, const allocator_type& alloc) noexcept
+  : msg(m, alloc)
+#ifdef RESULTS_BACKTRACE
+  , trace(backtrace::capture())
+#endif
+{
+}
+
+error::error(const allocator_type& alloc) noexcept
+  : error("", alloc)
+{
+}
+
+error::error(const error& other, const allocator_type& alloc)
+  : msg(other.msg, alloc)
+#ifdef RESULTS_BACKTRACE
+  , trace(other.trace)
+#endif
+{
+}
+
+error::error(error&& other, const allocator_type& alloc)
+  : msg(std::move(other.msg), alloc)
+#ifdef RESULTS_BACKTRACE
+  , trace(other.trace)
+#endif
+{
+}
+
+error::allocator_type error::get_allocator() const noexcept
+{
+  return msg.get_allocator();
+}
+
+} // namespace pmr
+} // namespace results
@@ -0,0 +1,132 @@
+#include "recorder.hh"
+#include "thread_rings.hh"
+#include "timestamp.hh"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+
+namespace results {
+namespace internal {
+namespace {
+
+constexpr std::size_t message_words = error_record::max_message / sizeof(std::uint64_t);
+
+static_assert(error_record::max_message % sizeof(std::uint64_t) == 0);
+
+// an error record without its strings, as a slot holds it
+struct raw_record
+{
+  std::uint64_t                            timestamp;
+  const char*                              file;
+  const char*                              function;
+  std::uint64_t                            position; // line << 32 | column
+  std::int64_t                             code;
+  std::uint64_t                            kind_and_length;
+  std::array<std::uint64_t, message_words> message;
+};
+
+struct record_payload
+{
+  using snapshot = raw_record;
+
+  snapshot load() const noexcept
+  {
+    snapshot r;
+    for(std::size_t i = 0; i < message_words; ++i)
+    {
+      r.message[i] = message[i].load(std::memory_order_relaxed);
+    }
+    r.timestamp       = timestamp.load(std::memory_order_relaxed);
+    r.file            = file.load(std::memory_order_relaxed);
+    r.function        = function.load(std::memory_order_relaxed);
+    r.position        = position.load(std::memory_order_relaxed);
+    r.code            = code.load(std::memory_order_relaxed);
+    r.kind_and_length = kind_and_length.load(std::memory_order_relaxed);
+    return r;
+  }
+
+  std::atomic<std::uint64_t>                            timestamp{0};
+  std::atomic<const char*>                              file{nullptr};
+  std::atomic<const char*>                              function{nullptr};
+  std::atomic<std::uint64_t>                            position{0};
+  std::atomic<std::int64_t>                             code{0};
+  std::atomic<std::uint64_t>                            kind_and_length{0};
+  std::array<std::atomic<std::uint64_t>, message_words> message{};
+};
+
+static_assert(sizeof(record_payload) + sizeof(std::uint64_t) == 128, "with its sequence a slot fills two cache lines");
+
+using record_rings = thread_rings<record_payload, 1024>;
+
+// records up to here were cleared
+std::atomic<std::uint64_t> s_cutoff{0};
+
+error_record to_record(const raw_record& r, std::uint32_t thread, const timestamp_converter& clock)
+{
+  error_record out;
+  out.timestamp = clock.to_ns(r.timestamp);
+  out.thread    = thread;
+  out.kind      = static_cast<record_kind>(r.kind_and_length & 0xff);
+  out.file      = r.file ? std::string_view(r.file) : std::string_view();
+  out.function  = r.function ? std::string_view(r.function) : std::string_view();
+  out.line      = static_cast<std::uint_least32_t>(r.position >> 32);
+  out.column    = static_cast<std::uint_least32_t>(r.position & 0xffffffff);
+  out.code      = r.code;
+  out.message.assign(reinterpret_cast<const char*>(r.message.data()), static_cast<std::size_t>(r.kind_and_length >> 8));
+  return out;
+}
+
+} // namespace
+
+void record_error(record_kind kind, const std::source_location& site, std::int64_t code, std::string_view msg) noexcept
+{
+  auto length = std::min(msg.size(), error_record::max_message);
+  std::array<std::uint64_t, message_words> words{};
+  std::memcpy(words.data(), msg.data(), length);
+
+  record_rings::write([&](record_payload& p) {
+    for(std::size_t i = 0; i < message_words; ++i)
+    {
+      p.message[i].store(words[i], std::memory_order_relaxed);
+    }
+    p.timestamp.store(timestamp(), std::memory_order_relaxed);
+    p.file.store(site.file_name(), std::memory_order_relaxed);
+    p.function.store(site.function_name(), std::memory_order_relaxed);
+    p.position.store(std::uint64_t(site.line()) << 32 | site.column(), std::memory_order_relaxed);
+    p.code.store(code, std::memory_order_relaxed);
+    p.kind_and_length.store(std::uint64_t(length) << 8 | std::uint64_t(kind), std::memory_order_relaxed);
+  });
+}
+
+} // namespace internal
+
+std::vector<error_record> dump_error_records()
+{
+  auto       entries = internal::record_rings::collect();
+  const auto cutoff  = internal::s_cutoff.load(std::memory_order_relaxed);
+  entries.erase(std::remove_if(entries.begin(),
+                               entries.end(),
+                               [&](const internal::record_rings::entry& e) { return e.value.timestamp <= cutoff; }),
+                entries.end());
+  std::stable_sort(entries.begin(), entries.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.value.timestamp < rhs.value.timestamp;
+  });
+
+  const internal::timestamp_converter clock;
+  std::vector<error_record>           records;
+  records.reserve(entries.size());
+  for(const auto& e : entries)
+  {
+    records.push_back(internal::to_record(e.value, e.thread, clock));
+  }
+  return records;
+}
+
+void clear_error_records()
+{
+  internal::s_cutoff.store(internal::timestamp(), std::memory_order_relaxed);
+  internal::record_rings::clear_retired();
+}
+
+} // namespace results
@@ -1,10 +1,86 @@
 #include "result.hh"
+#include <utility>
 
 namespace results {
 
 error::error(std::string_view m) noexcept
   : msg(m)
+#ifdef RESULTS_BACKTRACE
+  , trace(backtrace::capture())
+#endif
 {
 }
 
+bool operator==(const error& lhs, const error& rhs) noexcept
+{
+  return lhs.msg == rhs.msg;
+}
+
+bool operator!=(const error& lhs, const error& rhs) noexcept
+{
+  return !(lhs == rhs);
+}
+
+bool operator<(const error& lhs, const error& rhs) noexcept
+{
+  return lhs.msg < rhs.msg;
+}
+
+exception_error::exception_error(std::exception_ptr e) noexcept
+  : d_exception(std::move(e))
+{
+  if(!d_exception)
+  {
+    return;
+  }
+  try
+  {
+    rethrow();
+  }
+  catch(const std::exception& x)
+  {
+    d_std = &x;
+  }
+  catch(...)
+  {
+  }
+}
+
+exception_error::exception_error(exception_error&& other) noexcept
+  : d_exception(std::move(other.d_exception))
+  , d_std(std::exchange(other.d_std, nullptr))
+{
+}
+
+exception_error& exception_error::operator=(exception_error&& other) noexcept
+{
+  d_exception = std::move(other.d_exception);
+  d_std       = std::exchange(other.d_std, nullptr);
+  return *this;
+}
+
+const std::exception_ptr& exception_error::exception() const noexcept
+{
+  return d_exception;
+}
+
+void exception_error::rethrow() const
+{
+  std::rethrow_exception(d_exception);
+}
+
+const char* exception_error::what() const noexcept
+{
+  return d_std ? d_std->what() : "non-std exception";
+}
+
 } // namespace results
+
+namespace std {
+
+size_t hash<results::error>::operator()(const results::error& e) const noexcept
+{
+  return hash<string>{}(e.msg);
+}
+
+} // namespace std
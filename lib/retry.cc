@@ -0,0 +1,47 @@
+#include "retry.hh"
+#include <algorithm>
+#include <cmath>
+
+namespace results {
+
+std::chrono::nanoseconds attempt_stats::percentile(double p) const noexcept
+{
+  auto finished = ok + err;
+  if(finished == 0)
+  {
+    return std::chrono::nanoseconds::zero();
+  }
+
+  auto          wanted = static_cast<std::uint64_t>(std::ceil(std::clamp(p, 0.0, 1.0) * static_cast<double>(finished)));
+  std::uint64_t seen   = 0;
+  for(std::size_t i = 0; i < buckets; ++i)
+  {
+    seen += histogram[i];
+    if(seen >= wanted && seen > 0)
+    {
+      // bucket i holds latencies in [2^i, 2^(i+1)), bucket 0 also holds 0
+      return i + 1 < buckets - 1 ? std::chrono::nanoseconds(std::int64_t(1) << (i + 1)) : max_latency;
+    }
+  }
+  return max_latency;
+}
+
+void attempt_stats::record(std::chrono::nanoseconds latency, bool is_ok, bool is_abandoned) noexcept
+{
+  ++attempts;
+  ++(is_ok ? ok : err);
+  if(is_abandoned)
+  {
+    ++abandoned;
+  }
+
+  latency = std::max(latency, std::chrono::nanoseconds::zero());
+  total_latency += latency;
+  max_latency = std::max(max_latency, latency);
+
+  auto ns     = static_cast<std::uint64_t>(latency.count());
+  auto bucket = ns == 0 ? 0 : 63 - __builtin_clzll(ns);
+  ++histogram[static_cast<std::size_t>(bucket)];
+}
+
+} // namespace results
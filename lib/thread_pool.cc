@@ -0,0 +1,56 @@
+#include "thread_pool.hh"
+#include <utility>
+
+namespace results {
+
+thread_pool::thread_pool(std::size_t threads, std::size_t queue_capacity)
+  : d_tasks(queue_capacity)
+{
+  d_workers.reserve(threads);
+  for(std::size_t i = 0; i < threads; ++i)
+  {
+    d_workers.emplace_back([this] { work(); });
+  }
+}
+
+thread_pool::~thread_pool()
+{
+  shutdown();
+}
+
+std::size_t thread_pool::size() const noexcept
+{
+  return d_workers.size();
+}
+
+bool thread_pool::submit(std::function<void()> task)
+{
+  return d_tasks.push(result<std::function<void()>>::ok(std::move(task)));
+}
+
+void thread_pool::shutdown()
+{
+  if(!d_tasks.close(error("thread pool shut down")))
+  {
+    return;
+  }
+  for(auto& worker : d_workers)
+  {
+    worker.join();
+  }
+}
+
+void thread_pool::work()
+{
+  for(;;)
+  {
+    auto task = d_tasks.pop();
+    if(task.is_err())
+    {
+      return;
+    }
+    task.unwrap_unchecked()();
+  }
+}
+
+} // namespace results
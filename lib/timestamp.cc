@@ -0,0 +1,39 @@
+#include "timestamp.hh"
+
+namespace results {
+namespace internal {
+namespace {
+
+std::uint64_t steady_ns() noexcept
+{
+  return static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// a point known on both clocks, taken when the library is loaded
+struct calibration
+{
+  std::uint64_t ticks = timestamp();
+  std::uint64_t ns    = steady_ns();
+};
+
+const calibration s_start;
+
+} // namespace
+
+timestamp_converter::timestamp_converter() noexcept
+{
+  // through the two points known of both clocks, the start and now
+  const auto now_ticks = timestamp();
+  const auto now_ns    = steady_ns();
+  d_rate               = now_ticks > s_start.ticks ? double(now_ns - s_start.ns) / double(now_ticks - s_start.ticks) : 1;
+}
+
+std::uint64_t timestamp_converter::to_ns(std::uint64_t t) const noexcept
+{
+  const auto elapsed = static_cast<double>(static_cast<std::int64_t>(t - s_start.ticks));
+  return static_cast<std::uint64_t>(static_cast<std::int64_t>(s_start.ns) + static_cast<std::int64_t>(elapsed * d_rate));
+}
+
+} // namespace internal
+} // namespace results
@@ -0,0 +1,171 @@
+#include "trace.hh"
+#include "thread_rings.hh"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <ostream>
+#include <sstream>
+#include <unistd.h>
+
+namespace results {
+namespace internal {
+namespace {
+
+// a span with raw timestamps, as a slot holds it
+struct raw_span
+{
+  const char*   name;
+  std::uint64_t start;
+  std::uint64_t end_and_outcome; // end << 2 | outcome
+};
+
+struct span_payload
+{
+  using snapshot = raw_span;
+
+  snapshot load() const noexcept
+  {
+    return {name.load(std::memory_order_relaxed),
+            start.load(std::memory_order_relaxed),
+            end_and_outcome.load(std::memory_order_relaxed)};
+  }
+
+  std::atomic<const char*>   name{nullptr};
+  std::atomic<std::uint64_t> start{0};
+  std::atomic<std::uint64_t> end_and_outcome{0};
+};
+
+static_assert(sizeof(span_payload) + sizeof(std::uint64_t) == 32, "with its sequence a slot fills half a cache line");
+
+using span_rings = thread_rings<span_payload, 4096>;
+
+// spans started up to here were cleared
+std::atomic<std::uint64_t> s_cutoff{0};
+
+void write_escaped(std::ostream& out, std::string_view s)
+{
+  static constexpr char hex[] = "0123456789abcdef";
+  for(unsigned char c : s)
+  {
+    if(c == '"' || c == '\\')
+    {
+      out << '\\' << c;
+    }
+    else if(c < 0x20)
+    {
+      out << "\\u00" << hex[c >> 4] << hex[c & 0xf];
+    }
+    else
+    {
+      out << c;
+    }
+  }
+}
+
+// nanoseconds as microseconds with three decimals, the unit of trace-event timestamps
+void write_microseconds(std::ostream& out, std::uint64_t ns)
+{
+  char buffer[32];
+  std::snprintf(buffer, sizeof(buffer), "%llu.%03u", static_cast<unsigned long long>(ns / 1000), static_cast<unsigned>(ns % 1000));
+  out << buffer;
+}
+
+} // namespace
+
+void record_span(const char* name, std::uint64_t start, std::uint64_t end, span_outcome outcome) noexcept
+{
+  span_rings::write([&](span_payload& p) {
+    p.name.store(name, std::memory_order_relaxed);
+    p.start.store(start, std::memory_order_relaxed);
+    p.end_and_outcome.store(end << 2 | std::uint64_t(outcome), std::memory_order_relaxed);
+  });
+}
+
+} // namespace internal
+
+std::vector<trace_event> snapshot_trace()
+{
+  auto       entries = internal::span_rings::collect();
+  const auto cutoff  = internal::s_cutoff.load(std::memory_order_relaxed);
+  entries.erase(std::remove_if(entries.begin(),
+                               entries.end(),
+                               [&](const internal::span_rings::entry& e) { return e.value.start <= cutoff; }),
+                entries.end());
+  std::stable_sort(entries.begin(), entries.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.value.start < rhs.value.start;
+  });
+
+  const internal::timestamp_converter clock;
+  std::vector<trace_event>           events;
+  events.reserve(entries.size());
+  for(const auto& e : entries)
+  {
+    const auto& s     = e.value;
+    auto        start = clock.to_ns(s.start);
+    auto        end   = clock.to_ns(s.end_and_outcome >> 2);
+    events.push_back({s.name ? std::string_view(s.name) : std::string_view(),
+                      start,
+                      end > start ? end - start : 0,
+                      e.thread,
+                      static_cast<span_outcome>(s.end_and_outcome & 3)});
+  }
+  return events;
+}
+
+void clear_trace()
+{
+  internal::s_cutoff.store(internal::timestamp(), std::memory_order_relaxed);
+  internal::span_rings::clear_retired();
+}
+
+void write_chrome_trace(std::ostream& out)
+{
+  const auto pid = static_cast<long>(::getpid());
+
+  out << "{\"traceEvents\":[";
+  bool first = true;
+  for(const auto& e : snapshot_trace())
+  {
+    out << (first ? "\n" : ",\n") << "{\"name\":\"";
+    internal::write_escaped(out, e.name);
+    out << "\",\"cat\":\"result\",\"ph\":\"X\",\"ts\":";
+    internal::write_microseconds(out, e.start);
+    out << ",\"dur\":";
+    internal::write_microseconds(out, e.duration);
+    out << ",\"pid\":" << pid << ",\"tid\":" << e.thread;
+    if(e.outcome != span_outcome::none)
+    {
+      out << ",\"args\":{\"outcome\":\"" << (e.outcome == span_outcome::ok ? "ok" : "err") << "\"}";
+    }
+    out << '}';
+    first = false;
+  }
+  out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+}
+
+result<std::size_t, io::sys_error> export_chrome_trace(const std::filesystem::path& path)
+{
+  std::ostringstream json;
+  write_chrome_trace(json);
+  const auto text = json.str();
+
+  auto* f = std::fopen(path.c_str(), "w");
+  if(!f)
+  {
+    return result<std::size_t, io::sys_error>::err(io::last_error("fopen"));
+  }
+  auto written = std::fwrite(text.data(), 1, text.size(), f);
+  auto error   = written != text.size() ? io::last_error("fwrite") : io::sys_error{0, nullptr};
+  if(std::fclose(f) != 0 && error.code == 0)
+  {
+    error = io::last_error("fclose");
+  }
+  if(error.code != 0)
+  {
+    return result<std::size_t, io::sys_error>::err(error);
+  }
+  return result<std::size_t, io::sys_error>::ok(written);
+}
+
+} // namespace results
@@ -9,16 +9,34 @@ panicked::panicked(std::string_view msg)
 {
 }
 
+panicked::panicked(std::string_view msg, const backtrace& trace)
+  : d_msg(msg)
+  , d_trace(trace)
+{
+}
+
 const char* panicked::what() const noexcept
 {
   return d_msg.c_str();
 }
 
+const backtrace& panicked::trace() const noexcept
+{
+  return d_trace;
+}
+
 namespace internal {
 
-void panic(std::string_view msg)
+void panic(std::string_view msg, const call_site& site)
 {
-  throw panicked(std::string(msg));
+#ifdef RESULTS_INSTRUMENT
+  count_panic(msg, site);
+#endif
+#ifdef RESULTS_RECORD
+  record_error(record_kind::panic, site, 0, msg);
+#endif
+  (void)site;
+  throw panicked(msg, backtrace::capture());
 }
 
 } // namespace internal
@@ -0,0 +1,170 @@
+#include "allocation_counter.hh"
+#include <cstdlib>
+#include <new>
+
+namespace results {
+namespace {
+
+struct thread_counts
+{
+  std::size_t allocations   = 0;
+  std::size_t deallocations = 0;
+  std::size_t bytes         = 0;
+};
+
+// trivially destructible, so it is usable from operator delete during thread teardown
+thread_local thread_counts s_counts;
+
+void* allocate(std::size_t size, std::size_t alignment)
+{
+  ++s_counts.allocations;
+  s_counts.bytes += size;
+
+  if(size == 0)
+  {
+    size = 1;
+  }
+  void* ptr = nullptr;
+  if(alignment > alignof(std::max_align_t))
+  {
+    ptr = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+  }
+  else
+  {
+    ptr = std::malloc(size);
+  }
+  return ptr;
+}
+
+void deallocate(void* ptr) noexcept
+{
+  if(ptr != nullptr)
+  {
+    ++s_counts.deallocations;
+    std::free(ptr);
+  }
+}
+
+} // namespace
+
+allocation_counter::allocation_counter() noexcept
+  : d_allocations(s_counts.allocations)
+  , d_deallocations(s_counts.deallocations)
+  , d_bytes(s_counts.bytes)
+{
+}
+
+std::size_t allocation_counter::allocations() const noexcept
+{
+  return s_counts.allocations - d_allocations;
+}
+
+std::size_t allocation_counter::deallocations() const noexcept
+{
+  return s_counts.deallocations - d_deallocations;
+}
+
+std::size_t allocation_counter::bytes() const noexcept
+{
+  return s_counts.bytes - d_bytes;
+}
+
+} // namespace results
+
+void* operator new(std::size_t size)
+{
+  if(void* ptr = results::allocate(size, alignof(std::max_align_t)))
+  {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+  return ::operator new(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+  if(void* ptr = results::allocate(size, static_cast<std::size_t>(alignment)))
+  {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+  return ::operator new(size, alignment);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+  return results::allocate(size, alignof(std::max_align_t));
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+  return results::allocate(size, alignof(std::max_align_t));
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+  return results::allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+  return results::allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* ptr) noexcept
+{
+  results::deallocate(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+  results::deallocate(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+  results::deallocate(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+  results::deallocate(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+  results::deallocate(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept
+{
+  results::deallocate(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept
+{
+  results::deallocate(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept
+{
+  results::deallocate(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+  results::deallocate(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+  results::deallocate(ptr);
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+
+namespace results {
+
+// Counts global operator new and delete calls made by the current thread while the counter is alive. Counters nest:
+// each reports only what happened since its own construction. Backed by the replacement operators in
+// allocation_counter.cc, which are linked into results_test.
+class allocation_counter
+{
+public:
+  allocation_counter() noexcept;
+
+  allocation_counter(const allocation_counter&) = delete;
+  allocation_counter& operator=(const allocation_counter&) = delete;
+
+  std::size_t allocations() const noexcept;
+
+  std::size_t deallocations() const noexcept;
+
+  std::size_t bytes() const noexcept;
+
+private:
+  std::size_t d_allocations;
+  std::size_t d_deallocations;
+  std::size_t d_bytes;
+};
+
+} // namespace results
+
+// fails the test if evaluating the statement allocated on this thread
+#define EXPECT_NO_ALLOCATIONS(statement)                                             \
+  do                                                                                 \
+  {                                                                                  \
+    ::results::allocation_counter results_allocation_counter_;                       \
+    statement;                                                                       \
+    EXPECT_EQ(0u, results_allocation_counter_.allocations()) << "in: " #statement;   \
+  } while(false)
+
+#define EXPECT_ALLOCATES(statement)                                                  \
+  do                                                                                 \
+  {                                                                                  \
+    ::results::allocation_counter results_allocation_counter_;                       \
+    statement;                                                                       \
+    EXPECT_LT(0u, results_allocation_counter_.allocations()) << "in: " #statement;   \
+  } while(false)
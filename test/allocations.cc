@@ -0,0 +1,178 @@
+#include <gtest/gtest.h>
+#include "allocation_counter.hh"
+#include "channel.hh"
+#include "option.hh"
+#include "parse.hh"
+#include "result.hh"
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace results {
+namespace {
+
+// Operations documented as non-allocating must stay that way for payloads that do not allocate themselves. Each
+// check covers a single call; its inputs are built outside of the counted statement.
+
+using int_option = option<int>;
+using int_result = result<int, int>;
+using two_errors = result<int, int, parse_error>;
+
+class allocations : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    // instrumented builds allocate the per-thread call site counters on first use
+    (void)int_result::ok(0);
+  }
+};
+
+TEST(allocation_counter, counts_this_thread)
+{
+  allocation_counter outer;
+  auto               p = std::make_unique<int>(1);
+  {
+    allocation_counter inner;
+    auto               q = std::make_unique<long>(2);
+    EXPECT_EQ(1u, inner.allocations());
+    EXPECT_EQ(sizeof(long), inner.bytes());
+  }
+  EXPECT_EQ(2u, outer.allocations());
+  EXPECT_EQ(1u, outer.deallocations());
+}
+
+TEST_F(allocations, option_construction_and_access)
+{
+  auto s = make_some<int>(1);
+  auto n = make_none<int>();
+
+  EXPECT_NO_ALLOCATIONS(make_some<int>(1));
+  EXPECT_NO_ALLOCATIONS(make_none<int>());
+  EXPECT_NO_ALLOCATIONS(int_option::some(1));
+  EXPECT_NO_ALLOCATIONS(int_option::none());
+  EXPECT_NO_ALLOCATIONS(int_option copy(s));
+  EXPECT_NO_ALLOCATIONS(s.is_some());
+  EXPECT_NO_ALLOCATIONS(n.is_none());
+  EXPECT_NO_ALLOCATIONS(s.unwrap());
+  EXPECT_NO_ALLOCATIONS(s.expect("some"));
+  EXPECT_NO_ALLOCATIONS(s.unwrap_unchecked());
+  EXPECT_NO_ALLOCATIONS(n.unwrap_or(2));
+  EXPECT_NO_ALLOCATIONS(n.unwrap_or_else([] { return 2; }));
+}
+
+TEST_F(allocations, option_combinators)
+{
+  auto s = make_some<int>(1);
+  auto n = make_none<int>();
+
+  EXPECT_NO_ALLOCATIONS(s.and_(n));
+  EXPECT_NO_ALLOCATIONS(s.or_(n));
+  EXPECT_NO_ALLOCATIONS(s.xor_(n));
+  EXPECT_NO_ALLOCATIONS(n.or_else([] { return make_some<int>(2); }));
+  EXPECT_NO_ALLOCATIONS(s.match([](int i) { return i; }, [] { return 0; }));
+  EXPECT_NO_ALLOCATIONS(s.and_then([](int i) { return make_some<int>(i + 1); }));
+  EXPECT_NO_ALLOCATIONS(s.filter([](int i) { return i > 0; }));
+  EXPECT_NO_ALLOCATIONS(s.map([](int i) { return i + 1; }));
+  EXPECT_NO_ALLOCATIONS(s.map_or([](int i) { return i + 1; }, 0));
+  EXPECT_NO_ALLOCATIONS(s.map_or_else([](int i) { return i + 1; }, [] { return 0; }));
+  EXPECT_NO_ALLOCATIONS(s.consume([](int i) { return i + 1; }));
+}
+
+TEST_F(allocations, option_mutation_comparison_and_hash)
+{
+  auto s = make_some<int>(1);
+  auto n = make_none<int>();
+
+  EXPECT_NO_ALLOCATIONS(n.get_or_insert(2));
+  EXPECT_NO_ALLOCATIONS(s.get_or_insert_with([] { return 3; }));
+  EXPECT_NO_ALLOCATIONS(s.replace(4));
+  EXPECT_NO_ALLOCATIONS(s.take());
+  EXPECT_NO_ALLOCATIONS((void)(s == n));
+  EXPECT_NO_ALLOCATIONS((void)(s < n));
+  EXPECT_NO_ALLOCATIONS((void)(s == 1));
+  EXPECT_NO_ALLOCATIONS(std::hash<int_option>{}(s));
+}
+
+TEST_F(allocations, result_construction_and_access)
+{
+  auto ok  = make_ok<int, int>(1);
+  auto err = make_err<int, int>(2);
+
+  EXPECT_NO_ALLOCATIONS(int_result::ok(1));
+  EXPECT_NO_ALLOCATIONS(int_result::err(1));
+  EXPECT_NO_ALLOCATIONS(int_result copy(ok));
+  EXPECT_NO_ALLOCATIONS(ok.is_ok());
+  EXPECT_NO_ALLOCATIONS(err.is_err());
+  EXPECT_NO_ALLOCATIONS(ok.unwrap());
+  EXPECT_NO_ALLOCATIONS(ok.expect("ok"));
+  EXPECT_NO_ALLOCATIONS(err.unwrap_err());
+  EXPECT_NO_ALLOCATIONS(err.expect_err("err"));
+  EXPECT_NO_ALLOCATIONS(ok.unwrap_unchecked());
+  EXPECT_NO_ALLOCATIONS(err.unwrap_err_unchecked());
+  EXPECT_NO_ALLOCATIONS(err.unwrap_or(3));
+  EXPECT_NO_ALLOCATIONS(err.unwrap_or_else([] { return 3; }));
+}
+
+TEST_F(allocations, result_combinators)
+{
+  auto ok  = make_ok<int, int>(1);
+  auto err = make_err<int, int>(2);
+
+  EXPECT_NO_ALLOCATIONS(ok.and_(err));
+  EXPECT_NO_ALLOCATIONS(ok.or_(err));
+  EXPECT_NO_ALLOCATIONS(err.or_else([] { return int_result::ok(3); }));
+  EXPECT_NO_ALLOCATIONS(ok.match([](int i) { return i; }, [](int e) { return -e; }));
+  EXPECT_NO_ALLOCATIONS(ok.and_then([](int i) { return int_result::ok(i + 1); }));
+  EXPECT_NO_ALLOCATIONS(ok.map([](int i) { return i + 1; }));
+  EXPECT_NO_ALLOCATIONS(err.map_err([](int e) { return e + 1; }));
+  EXPECT_NO_ALLOCATIONS(ok.map_or_else([](int i) { return i; }, [](int e) { return -e; }));
+  EXPECT_NO_ALLOCATIONS(ok.consume([](int i) { return i + 1; }));
+  EXPECT_NO_ALLOCATIONS((void)(ok == err));
+  EXPECT_NO_ALLOCATIONS((void)(ok < err));
+  EXPECT_NO_ALLOCATIONS((void)(ok == 1));
+  EXPECT_NO_ALLOCATIONS(std::hash<int_result>{}(ok));
+}
+
+TEST_F(allocations, result_with_several_errors)
+{
+  auto narrow = int_result::err(1);
+  auto wide   = two_errors::err(parse_error{0, parse_errc::invalid});
+
+  EXPECT_NO_ALLOCATIONS(two_errors widened(narrow));
+  EXPECT_NO_ALLOCATIONS(wide.holds_err<parse_error>());
+  EXPECT_NO_ALLOCATIONS(wide.unwrap_err<parse_error>());
+  EXPECT_NO_ALLOCATIONS(narrow.and_then([](int i) { return two_errors::ok(i); }));
+  EXPECT_NO_ALLOCATIONS(parse<int>("123"));
+  EXPECT_NO_ALLOCATIONS(parse<int>("nope"));
+}
+
+TEST_F(allocations, error_messages)
+{
+  // short messages fit the string's inline buffer
+  EXPECT_NO_ALLOCATIONS(error e("short"));
+  EXPECT_ALLOCATES(error e("a message too long to be stored inline"));
+
+  auto long_err = make_err<int>("a message too long to be stored inline");
+  EXPECT_ALLOCATES(result<int> copy(long_err));
+  EXPECT_ALLOCATES(long_err.map_err([](const error& e) { return e; }));
+}
+
+TEST_F(allocations, make_from_throwable)
+{
+  EXPECT_NO_ALLOCATIONS(make_from_throwable([] { return 1; }));
+  EXPECT_ALLOCATES(make_from_throwable([]() -> int { throw std::runtime_error("thrown"); }));
+}
+
+TEST_F(allocations, channel_transfer)
+{
+  channel<int, int> ch(4);
+  auto              value = int_result::ok(1);
+
+  EXPECT_NO_ALLOCATIONS(ch.try_push(std::move(value)));
+  EXPECT_NO_ALLOCATIONS(ch.try_pop());
+}
+
+} // namespace
+} // namespace results
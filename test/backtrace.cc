@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include "backtrace.hh"
+#include "option.hh"
+#include "result.hh"
+#include <algorithm>
+#include <string>
+
+namespace results {
+namespace {
+
+class sampling_guard
+{
+public:
+  explicit sampling_guard(unsigned every_n)
+    : d_previous(backtrace_sampling())
+  {
+    set_backtrace_sampling(every_n);
+  }
+
+  ~sampling_guard()
+  {
+    set_backtrace_sampling(d_previous);
+  }
+
+private:
+  unsigned d_previous;
+};
+
+TEST(backtrace, default_is_empty)
+{
+  backtrace bt;
+  EXPECT_TRUE(bt.empty());
+  EXPECT_EQ(0, bt.size());
+  EXPECT_EQ(bt.begin(), bt.end());
+}
+
+TEST(backtrace, capture_always)
+{
+  sampling_guard guard(0);
+
+  auto bt = backtrace::capture_always();
+  EXPECT_FALSE(bt.empty());
+  EXPECT_LE(bt.size(), backtrace::max_frames);
+}
+
+TEST(backtrace, capture_is_off_by_default)
+{
+  sampling_guard guard(0);
+  EXPECT_TRUE(backtrace::capture().empty());
+}
+
+TEST(backtrace, capture_every_call)
+{
+  sampling_guard guard(1);
+  EXPECT_FALSE(backtrace::capture().empty());
+  EXPECT_FALSE(backtrace::capture().empty());
+}
+
+TEST(backtrace, capture_sampled)
+{
+  sampling_guard guard(4);
+
+  int captured = 0;
+  for(int i = 0; i < 40; ++i)
+  {
+    captured += backtrace::capture().empty() ? 0 : 1;
+  }
+  EXPECT_EQ(10, captured);
+}
+
+TEST(backtrace, to_string_has_a_line_per_frame)
+{
+  auto bt = backtrace::capture_always();
+  auto s  = bt.to_string();
+
+  EXPECT_EQ(bt.size(), std::count(s.begin(), s.end(), '\n'));
+  EXPECT_EQ(0, s.find("#0 "));
+}
+
+TEST(backtrace, panic_records_trace)
+{
+  sampling_guard guard(1);
+  try
+  {
+    make_none<int>().unwrap();
+    FAIL() << "above should have thrown";
+  }
+  catch(const panicked& p)
+  {
+    EXPECT_FALSE(p.trace().empty());
+  }
+}
+
+TEST(backtrace, panic_without_sampling_has_empty_trace)
+{
+  sampling_guard guard(0);
+  try
+  {
+    make_err<int>("booh").unwrap();
+    FAIL() << "above should have thrown";
+  }
+  catch(const panicked& p)
+  {
+    EXPECT_TRUE(p.trace().empty());
+  }
+}
+
+#ifdef RESULTS_BACKTRACE
+TEST(backtrace, error_records_trace)
+{
+  sampling_guard guard(1);
+  EXPECT_FALSE(make_err<int>("booh").unwrap_err().trace.empty());
+}
+#endif
+
+} // namespace
+} // namespace results
@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+#include "channel.hh"
+#include <memory>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+namespace results {
+namespace {
+
+TEST(channel, capacity_is_rounded_up)
+{
+  EXPECT_EQ(8, (channel<int>(5).capacity()));
+  EXPECT_EQ(1, (channel<int>(1).capacity()));
+}
+
+TEST(channel, push_and_pop_in_order)
+{
+  channel<int> c(4);
+
+  EXPECT_TRUE(c.try_push(make_ok<int>(1)));
+  EXPECT_TRUE(c.try_push(make_err<int>("booh")));
+  EXPECT_TRUE(c.try_push(make_ok<int>(3)));
+
+  EXPECT_EQ(1, c.try_pop().unwrap().unwrap());
+  EXPECT_EQ("booh", c.try_pop().unwrap().unwrap_err().msg);
+  EXPECT_EQ(3, c.try_pop().unwrap().unwrap());
+  EXPECT_TRUE(c.try_pop().is_none());
+}
+
+TEST(channel, try_push_fails_when_full)
+{
+  channel<int> c(2);
+
+  EXPECT_TRUE(c.try_push(make_ok<int>(1)));
+  EXPECT_TRUE(c.try_push(make_ok<int>(2)));
+
+  auto value = make_ok<int>(3);
+  EXPECT_FALSE(c.try_push(std::move(value)));
+  EXPECT_EQ(3, value.unwrap());
+
+  c.try_pop();
+  EXPECT_TRUE(c.try_push(std::move(value)));
+}
+
+TEST(channel, moves_payloads)
+{
+  channel<std::unique_ptr<int>> c(2);
+
+  EXPECT_TRUE(c.try_push(make_ok<std::unique_ptr<int>>(std::make_unique<int>(42))));
+
+  int val = 0;
+  c.pop().consume([&](auto&& p) { val = *p; return 0; });
+  EXPECT_EQ(42, val);
+}
+
+TEST(channel, close_delivers_remaining_then_terminal_error)
+{
+  channel<int> c(4);
+
+  c.try_push(make_ok<int>(1));
+  EXPECT_TRUE(c.close(error("done")));
+  EXPECT_FALSE(c.close(error("again")));
+  EXPECT_TRUE(c.is_closed());
+
+  EXPECT_FALSE(c.try_push(make_ok<int>(2)));
+  EXPECT_FALSE(c.push(make_ok<int>(2)));
+
+  EXPECT_EQ(1, c.pop().unwrap());
+  EXPECT_EQ("done", c.pop().unwrap_err().msg);
+  EXPECT_EQ("done", c.try_pop().unwrap().unwrap_err().msg);
+}
+
+TEST(channel, batch)
+{
+  channel<int>             c(4);
+  std::vector<result<int>> in;
+  for(int i = 0; i < 6; ++i)
+  {
+    in.push_back(make_ok<int>(i));
+  }
+
+  auto pushed = c.try_push_batch(in.begin(), in.end());
+  EXPECT_EQ(4, pushed - in.begin());
+
+  std::vector<result<int>> out;
+  c.try_pop_batch(std::back_inserter(out), 3);
+  ASSERT_EQ(3, out.size());
+  EXPECT_EQ(0, out[0].unwrap());
+  EXPECT_EQ(2, out[2].unwrap());
+
+  c.close(error("done"));
+  c.try_pop_batch(std::back_inserter(out), 3);
+  ASSERT_EQ(4, out.size());
+  EXPECT_EQ(3, out[3].unwrap());
+
+  c.try_pop_batch(std::back_inserter(out), 3);
+  ASSERT_EQ(5, out.size());
+  EXPECT_EQ("done", out[4].unwrap_err().msg);
+}
+
+TEST(channel, multiple_producers_and_consumers)
+{
+  constexpr int producers = 4;
+  constexpr int consumers = 3;
+  constexpr int per_producer = 10000;
+
+  channel<int> c(64);
+
+  std::vector<std::thread> threads;
+  std::vector<long>        sums(consumers, 0);
+  std::vector<int>         errors(consumers, 0);
+
+  for(int i = 0; i < consumers; ++i)
+  {
+    threads.emplace_back([&, i] {
+      for(;;)
+      {
+        auto r = c.pop();
+        if(r.is_err())
+        {
+          if(r.unwrap_err().msg == "done")
+          {
+            return;
+          }
+          ++errors[i];
+        }
+        else
+        {
+          sums[i] += r.unwrap();
+        }
+      }
+    });
+  }
+
+  std::vector<std::thread> producer_threads;
+  for(int p = 0; p < producers; ++p)
+  {
+    producer_threads.emplace_back([&] {
+      for(int i = 1; i <= per_producer; ++i)
+      {
+        c.push(i % 100 == 0 ? make_err<int>("bad") : make_ok<int>(i));
+      }
+    });
+  }
+  for(auto&& t : producer_threads)
+  {
+    t.join();
+  }
+  c.close(error("done"));
+  for(auto&& t : threads)
+  {
+    t.join();
+  }
+
+  long expected = 0;
+  for(int i = 1; i <= per_producer; ++i)
+  {
+    expected += i % 100 == 0 ? 0 : i;
+  }
+  EXPECT_EQ(producers * expected, std::accumulate(sums.begin(), sums.end(), 0L));
+  EXPECT_EQ(producers * per_producer / 100, std::accumulate(errors.begin(), errors.end(), 0));
+}
+
+} // namespace
+} // namespace results
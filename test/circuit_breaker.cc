@@ -0,0 +1,221 @@
+#include <gtest/gtest.h>
+#include "circuit_breaker.hh"
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+
+namespace results {
+namespace {
+
+using namespace std::chrono_literals;
+
+// time only moves when a test advances it
+struct fake_clock
+{
+  using duration   = std::chrono::nanoseconds;
+  using rep        = duration::rep;
+  using period     = duration::period;
+  using time_point = std::chrono::time_point<fake_clock>;
+
+  static constexpr bool is_steady = true;
+
+  static inline std::atomic<rep> current{0};
+
+  static time_point now() noexcept
+  {
+    return time_point(duration(current.load()));
+  }
+
+  static void advance(duration d) noexcept
+  {
+    current += d.count();
+  }
+};
+
+using breaker = circuit_breaker<fake_clock>;
+using call    = result<int, std::string>;
+
+breaker_policy small_window()
+{
+  breaker_policy p;
+  p.failure_threshold = 0.5;
+  p.minimum_calls     = 4;
+  p.window            = 10s;
+  p.open_duration     = 5s;
+  return p;
+}
+
+call succeed()
+{
+  return call::ok(1);
+}
+
+call fail()
+{
+  return call::err("backend down");
+}
+
+class circuit_breaker_test : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    // a fresh window for every test
+    fake_clock::advance(1h);
+  }
+};
+
+TEST_F(circuit_breaker_test, stays_closed_below_minimum_calls)
+{
+  breaker b(small_window());
+  for(int i = 0; i < 3; ++i)
+  {
+    EXPECT_TRUE(b.run(fail).holds_err<std::string>());
+  }
+  EXPECT_EQ(breaker_state::closed, b.state());
+}
+
+TEST_F(circuit_breaker_test, opens_at_the_failure_threshold_and_fails_fast)
+{
+  breaker b(small_window());
+  b.run(succeed);
+  b.run(succeed);
+  b.run(fail);
+  EXPECT_EQ(breaker_state::closed, b.state());
+  b.run(fail);
+  EXPECT_EQ(breaker_state::open, b.state());
+
+  int  calls = 0;
+  auto r     = b.run([&] {
+    ++calls;
+    return succeed();
+  });
+  static_assert(std::is_same_v<decltype(r), result<int, std::string, circuit_open>>);
+  EXPECT_TRUE(r.holds_err<circuit_open>());
+  EXPECT_EQ(0, calls);
+  EXPECT_EQ(1u, b.stats().rejected);
+  EXPECT_EQ(1u, b.stats().trips);
+}
+
+TEST_F(circuit_breaker_test, rejects_with_the_callers_error)
+{
+  breaker b(small_window());
+  for(int i = 0; i < 4; ++i)
+  {
+    b.run(fail);
+  }
+
+  auto r = b.run(succeed, [] { return std::string("shed"); });
+  static_assert(std::is_same_v<decltype(r), call>);
+  EXPECT_EQ("shed", r.unwrap_err());
+}
+
+TEST_F(circuit_breaker_test, old_failures_slide_out_of_the_window)
+{
+  breaker b(small_window());
+  b.run(fail);
+  b.run(fail);
+  b.run(fail);
+  fake_clock::advance(11s);
+  b.run(succeed);
+  b.run(succeed);
+  b.run(succeed);
+  b.run(fail);
+  EXPECT_EQ(breaker_state::closed, b.state());
+}
+
+TEST_F(circuit_breaker_test, late_failures_do_not_extend_the_open_period)
+{
+  breaker b(small_window());
+  // admitted while closed, fails 3s after the breaker opened
+  auto slow = b.run([&] {
+    for(int i = 0; i < 4; ++i)
+    {
+      b.run(fail);
+    }
+    fake_clock::advance(3s);
+    return fail();
+  });
+  EXPECT_TRUE(slow.holds_err<std::string>());
+  EXPECT_EQ(breaker_state::open, b.state());
+  EXPECT_EQ(1u, b.stats().trips);
+
+  fake_clock::advance(2s);
+  EXPECT_EQ(1, b.run(succeed).unwrap());
+}
+
+TEST_F(circuit_breaker_test, successful_probe_closes)
+{
+  breaker b(small_window());
+  for(int i = 0; i < 4; ++i)
+  {
+    b.run(fail);
+  }
+  fake_clock::advance(4s);
+  EXPECT_TRUE(b.run(succeed).holds_err<circuit_open>());
+
+  fake_clock::advance(1s);
+  auto probe = b.run([&] {
+    EXPECT_EQ(breaker_state::half_open, b.state());
+    // only one probe at a time
+    EXPECT_TRUE(b.run(succeed).holds_err<circuit_open>());
+    return succeed();
+  });
+  EXPECT_EQ(1, probe.unwrap());
+  EXPECT_EQ(breaker_state::closed, b.state());
+
+  // the window starts over
+  for(int i = 0; i < 3; ++i)
+  {
+    b.run(fail);
+  }
+  EXPECT_EQ(breaker_state::closed, b.state());
+}
+
+TEST_F(circuit_breaker_test, failed_probe_opens_again)
+{
+  breaker b(small_window());
+  for(int i = 0; i < 4; ++i)
+  {
+    b.run(fail);
+  }
+  fake_clock::advance(5s);
+  EXPECT_TRUE(b.run(fail).holds_err<std::string>());
+  EXPECT_EQ(breaker_state::open, b.state());
+  EXPECT_EQ(2u, b.stats().trips);
+
+  // open for another full duration
+  fake_clock::advance(4s);
+  EXPECT_TRUE(b.run(succeed).holds_err<circuit_open>());
+}
+
+TEST_F(circuit_breaker_test, throwing_probe_counts_as_failed)
+{
+  breaker b(small_window());
+  for(int i = 0; i < 4; ++i)
+  {
+    b.run(fail);
+  }
+  fake_clock::advance(5s);
+  EXPECT_THROW(b.run([]() -> call { throw std::runtime_error("boom"); }), std::runtime_error);
+  EXPECT_EQ(breaker_state::open, b.state());
+
+  fake_clock::advance(5s);
+  EXPECT_EQ(1, b.run(succeed).unwrap());
+}
+
+TEST_F(circuit_breaker_test, reset_closes)
+{
+  breaker b(small_window());
+  for(int i = 0; i < 4; ++i)
+  {
+    b.run(fail);
+  }
+  b.reset();
+  EXPECT_EQ(breaker_state::closed, b.state());
+  EXPECT_EQ(1, b.run(succeed).unwrap());
+}
+
+} // namespace
+} // namespace results
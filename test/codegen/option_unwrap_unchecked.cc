@@ -0,0 +1,19 @@
+// Compiled on its own by the codegen tests in test/CMakeLists.txt, which require the loop to be vectorized.
+#include "option.hh"
+#include <algorithm>
+#include <vector>
+
+int sum_some(const std::vector<results::option<int>>& values)
+{
+  if(!std::all_of(values.begin(), values.end(), [](auto&& v) { return v.is_some(); }))
+  {
+    return 0;
+  }
+
+  int sum = 0;
+  for(auto&& v : values)
+  {
+    sum += v.unwrap_unchecked();
+  }
+  return sum;
+}
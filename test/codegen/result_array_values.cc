@@ -0,0 +1,17 @@
+// Compiled on its own by the codegen tests in test/CMakeLists.txt, which require the loop to be vectorized.
+#include "result_array.hh"
+
+int sum_ok(const results::result_array<int, long>& values)
+{
+  if(values.error_count() != 0)
+  {
+    return 0;
+  }
+
+  int sum = 0;
+  for(int v : values.values())
+  {
+    sum += v;
+  }
+  return sum;
+}
@@ -0,0 +1,19 @@
+// Compiled on its own by the codegen tests in test/CMakeLists.txt, which require the loop to be vectorized.
+#include "result.hh"
+#include <algorithm>
+#include <vector>
+
+int sum_ok(const std::vector<results::result<int, long>>& values)
+{
+  if(!std::all_of(values.begin(), values.end(), [](auto&& v) { return v.is_ok(); }))
+  {
+    return 0;
+  }
+
+  int sum = 0;
+  for(auto&& v : values)
+  {
+    sum += v.unwrap_unchecked();
+  }
+  return sum;
+}
@@ -0,0 +1,178 @@
+#include <gtest/gtest.h>
+#include "compose.hh"
+#include "recorder.hh"
+#include <string>
+#include <tuple>
+#include <type_traits>
+
+namespace results {
+namespace {
+
+// counts copies made of any instance
+struct counted
+{
+  static inline int copies = 0;
+
+  int value;
+
+  explicit counted(int v)
+    : value(v)
+  {
+  }
+
+  counted(const counted& other)
+    : value(other.value)
+  {
+    ++copies;
+  }
+
+  counted(counted&&) = default;
+
+  counted& operator=(const counted& other)
+  {
+    value = other.value;
+    ++copies;
+    return *this;
+  }
+
+  counted& operator=(counted&&) = default;
+};
+
+struct io_failure
+{
+  std::string path;
+};
+
+class compose : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    counted::copies = 0;
+  }
+};
+
+TEST_F(compose, zip_all_ok)
+{
+  auto a = result<counted, int>::ok(1);
+  auto b = result<std::string, int>::ok("b");
+
+  auto z = zip(std::move(a), std::move(b), result<int, int>::ok(3));
+  static_assert(std::is_same_v<decltype(z), result<std::tuple<counted, std::string, int>, int>>);
+
+  const auto& [x, y, w] = z.unwrap();
+  EXPECT_EQ(1, x.value);
+  EXPECT_EQ("b", y);
+  EXPECT_EQ(3, w);
+  EXPECT_EQ(0, counted::copies);
+}
+
+TEST_F(compose, zip_copies_lvalues)
+{
+  auto a = result<counted, int>::ok(1);
+  auto z = zip(a, result<counted, int>::ok(2));
+
+  EXPECT_EQ(1, std::get<0>(z.unwrap()).value);
+  EXPECT_EQ(1, counted::copies);
+}
+
+TEST_F(compose, zip_returns_first_error)
+{
+  auto z = zip(result<int, int>::ok(1), result<int, int>::err(2), result<int, int>::err(3));
+  EXPECT_EQ(2, z.unwrap_err());
+}
+
+TEST_F(compose, zip_unites_error_types)
+{
+  auto z = zip(result<int, int>::ok(1), result<int, io_failure>::err(io_failure{"x"}), result<int, int>::ok(2));
+  static_assert(std::is_same_v<decltype(z), result<std::tuple<int, int, int>, int, io_failure>>);
+  EXPECT_EQ("x", z.unwrap_err<io_failure>().path);
+}
+
+TEST_F(compose, passing_errors_on_produces_no_errors)
+{
+  auto failed = result<int, int>::err(2);
+  clear_error_records();
+
+  EXPECT_TRUE(zip(failed, result<int, int>::ok(1)).is_err());
+  EXPECT_TRUE(transpose(option<result<int, int>>::some(failed)).is_err());
+  EXPECT_TRUE(transpose(result<option<int>, int>::err(3)).is_some());
+
+  for(const auto& r : dump_error_records())
+  {
+    EXPECT_EQ(std::string_view::npos, r.file.find("compose.hh"));
+  }
+  for(const auto& s : snapshot_instrumentation().sites)
+  {
+    EXPECT_FALSE(s.kind == site_kind::err && s.file.find("compose.hh") != std::string_view::npos);
+  }
+}
+
+TEST_F(compose, transpose_option_of_result)
+{
+  using inner = result<counted, int>;
+
+  auto some_ok = transpose(option<inner>::some(inner::ok(1)));
+  static_assert(std::is_same_v<decltype(some_ok), result<option<counted>, int>>);
+  EXPECT_EQ(1, some_ok.unwrap().unwrap().value);
+
+  EXPECT_EQ(2, transpose(option<inner>::some(inner::err(2))).unwrap_err());
+  EXPECT_TRUE(transpose(option<inner>::none()).unwrap().is_none());
+  EXPECT_EQ(0, counted::copies);
+}
+
+TEST_F(compose, transpose_result_of_option)
+{
+  using outer = result<option<counted>, int>;
+
+  auto ok_some = transpose(outer::ok(option<counted>::some(1)));
+  static_assert(std::is_same_v<decltype(ok_some), option<result<counted, int>>>);
+  EXPECT_EQ(1, ok_some.unwrap().unwrap().value);
+
+  EXPECT_EQ(2, transpose(outer::err(2)).unwrap().unwrap_err());
+  EXPECT_TRUE(transpose(outer::ok(option<counted>::none())).is_none());
+  EXPECT_EQ(0, counted::copies);
+}
+
+TEST_F(compose, transpose_round_trip)
+{
+  auto o = option<result<int, int>>::some(result<int, int>::err(1));
+  EXPECT_TRUE(transpose(transpose(o)) == o);
+}
+
+TEST_F(compose, result_flatten)
+{
+  using inner = result<counted, int>;
+  using outer = result<inner, int>;
+
+  auto ok = outer::ok(inner::ok(1)).flatten();
+  static_assert(std::is_same_v<decltype(ok), inner>);
+  EXPECT_EQ(1, ok.unwrap().value);
+  EXPECT_EQ(0, counted::copies);
+
+  EXPECT_EQ(2, outer::ok(inner::err(2)).flatten().unwrap_err());
+  EXPECT_EQ(3, outer::err(3).flatten().unwrap_err());
+
+  auto lvalue = outer::ok(inner::ok(4));
+  EXPECT_EQ(4, lvalue.flatten().unwrap().value);
+  EXPECT_EQ(1, counted::copies);
+}
+
+TEST_F(compose, result_flatten_unites_error_types)
+{
+  using inner = result<int, io_failure>;
+
+  auto r = result<inner, int>::ok(inner::err(io_failure{"x"})).flatten();
+  static_assert(std::is_same_v<decltype(r), result<int, int, io_failure>>);
+  EXPECT_EQ("x", r.unwrap_err<io_failure>().path);
+}
+
+TEST_F(compose, option_flatten_moves)
+{
+  auto o = option<option<counted>>::some(option<counted>::some(1)).flatten();
+  EXPECT_EQ(1, o.unwrap().value);
+  EXPECT_EQ(0, counted::copies);
+}
+
+} // namespace
+} // namespace results
@@ -0,0 +1,213 @@
+#include <gtest/gtest.h>
+#include "allocation_counter.hh"
+#include "dyn_error.hh"
+#include "parse.hh"
+#include <array>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+
+namespace results {
+namespace {
+
+struct small_error
+{
+  int code;
+};
+
+struct large_error
+{
+  std::array<char, 64> detail;
+  int                  code;
+
+  std::string message() const
+  {
+    return "large " + std::to_string(code);
+  }
+};
+
+// owns its payload, cannot be copied
+struct move_only_error
+{
+  std::unique_ptr<std::string> detail;
+
+  std::string message() const
+  {
+    return *detail;
+  }
+};
+
+// counts live instances
+struct tracked
+{
+  static inline int live = 0;
+
+  int value;
+
+  explicit tracked(int v)
+    : value(v)
+  {
+    ++live;
+  }
+
+  tracked(const tracked& other)
+    : value(other.value)
+  {
+    ++live;
+  }
+
+  tracked(tracked&& other) noexcept
+    : value(other.value)
+  {
+    ++live;
+  }
+
+  ~tracked()
+  {
+    --live;
+  }
+};
+
+class dyn_error_test : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    // instrumented builds allocate the per-thread call site counters on first use
+    (void)dyn_result<int>::ok(0);
+    tracked::live = 0;
+  }
+};
+
+static_assert(sizeof(small_error) <= dyn_error::inline_size);
+static_assert(sizeof(large_error) > dyn_error::inline_size);
+
+TEST_F(dyn_error_test, small_errors_are_stored_inline)
+{
+  small_error e{7};
+  EXPECT_NO_ALLOCATIONS(dyn_error d(e));
+
+  dyn_error d(e);
+  EXPECT_TRUE(d.is_inline());
+  EXPECT_TRUE(d.is<small_error>());
+  ASSERT_NE(nullptr, d.downcast<small_error>());
+  EXPECT_EQ(7, d.downcast<small_error>()->code);
+  EXPECT_EQ("unknown error", d.message());
+}
+
+TEST_F(dyn_error_test, large_errors_are_boxed)
+{
+  large_error e{{}, 3};
+  EXPECT_ALLOCATES(dyn_error d(e));
+
+  dyn_error d(e);
+  EXPECT_FALSE(d.is_inline());
+  EXPECT_EQ(3, d.downcast<large_error>()->code);
+  EXPECT_EQ("large 3", d.message());
+
+  // moving a boxed error hands over the box
+  dyn_error moved(std::move(d));
+  EXPECT_TRUE(d.empty());
+  EXPECT_NO_ALLOCATIONS(dyn_error again(std::move(moved)));
+}
+
+TEST_F(dyn_error_test, downcast_matches_the_exact_type_only)
+{
+  dyn_error d(std::runtime_error("boom"));
+  EXPECT_EQ(nullptr, d.downcast<small_error>());
+  EXPECT_EQ(nullptr, d.downcast<std::exception>());
+  ASSERT_NE(nullptr, d.downcast<std::runtime_error>());
+  EXPECT_EQ("boom", d.message());
+
+  *d.downcast<std::runtime_error>() = std::runtime_error("replaced");
+  EXPECT_EQ("replaced", d.message());
+}
+
+TEST_F(dyn_error_test, strings_become_errors)
+{
+  dyn_error d("not found");
+  ASSERT_TRUE(d.is<error>());
+  EXPECT_EQ("not found", d.downcast<error>()->msg);
+  EXPECT_EQ("not found", d.message());
+
+  dyn_error code(std::make_error_code(std::errc::timed_out));
+  EXPECT_EQ(std::make_error_code(std::errc::timed_out).message(), code.message());
+}
+
+TEST_F(dyn_error_test, keeps_caught_exceptions)
+{
+  auto r = make_from_throwable<int (*)(), dyn_error>([]() -> int { throw std::runtime_error("boom"); });
+  ASSERT_TRUE(r.is_err());
+  const auto& d = r.unwrap_err();
+  ASSERT_TRUE(d.is<exception_error>());
+  EXPECT_EQ("boom", d.message());
+  EXPECT_NE(nullptr, d.downcast<exception_error>()->get_if<std::runtime_error>());
+}
+
+TEST_F(dyn_error_test, copies_and_destroys_the_payload)
+{
+  {
+    dyn_error a(tracked(1));
+    EXPECT_EQ(1, tracked::live);
+
+    dyn_error b(a);
+    EXPECT_EQ(2, tracked::live);
+    EXPECT_EQ(1, b.downcast<tracked>()->value);
+
+    b = dyn_error(small_error{2});
+    EXPECT_EQ(1, tracked::live);
+
+    b = a;
+    a = std::move(b);
+    EXPECT_EQ(1, tracked::live);
+    EXPECT_TRUE(b.empty());
+    EXPECT_EQ("", b.message());
+  }
+  EXPECT_EQ(0, tracked::live);
+}
+
+TEST_F(dyn_error_test, holds_move_only_errors)
+{
+  dyn_error a(move_only_error{std::make_unique<std::string>("socket closed")});
+  EXPECT_TRUE(a.is_inline());
+  EXPECT_FALSE(a.is_copyable());
+  EXPECT_EQ("socket closed", a.message());
+
+  dyn_error b(std::move(a));
+  EXPECT_TRUE(a.empty());
+  EXPECT_EQ("socket closed", *b.downcast<move_only_error>()->detail);
+  EXPECT_THROW(dyn_error c(b), panicked);
+
+  auto r = dyn_result<int>::err(move_only_error{std::make_unique<std::string>("eof")});
+  EXPECT_EQ("eof", r.unwrap_err().message());
+  EXPECT_TRUE(dyn_error(small_error{1}).is_copyable());
+}
+
+TEST_F(dyn_error_test, as_the_error_of_a_result)
+{
+  auto r = dyn_result<int>::err(small_error{5});
+  EXPECT_EQ(5, r.unwrap_err().downcast<small_error>()->code);
+
+  auto code = r.match([](int v) { return v; }, [](const dyn_error& e) { return -e.downcast<small_error>()->code; });
+  EXPECT_EQ(-5, code);
+
+  auto chained = dyn_result<int>::ok(1).and_then([](int v) { return dyn_result<int>::ok(v + 1); });
+  EXPECT_EQ(2, chained.unwrap());
+}
+
+TEST_F(dyn_error_test, map_err_erases_every_error_type)
+{
+  auto p = result<int, int, parse_error>::err(parse_error{2, parse_errc::out_of_range});
+  auto d = p.map_err(to_dyn_error);
+  static_assert(std::is_same_v<decltype(d), dyn_result<int>>);
+  EXPECT_EQ(parse_errc::out_of_range, d.unwrap_err().downcast<parse_error>()->kind);
+  EXPECT_EQ(p.unwrap_err<parse_error>().message(), d.unwrap_err().message());
+
+  auto i = result<int, int, parse_error>::err(4).map_err(to_dyn_error);
+  EXPECT_EQ(4, *i.unwrap_err().downcast<int>());
+}
+
+} // namespace
+} // namespace results
@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+#include "faults.hh"
+#include "option.hh"
+#include "result.hh"
+#include <source_location>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace results {
+namespace {
+
+// the decisions of n productions at one site
+std::vector<bool> decisions(const std::source_location& site, int n)
+{
+  std::vector<bool> out;
+  for(int i = 0; i < n; ++i)
+  {
+    out.push_back(internal::should_fault(site));
+  }
+  return out;
+}
+
+class faults : public ::testing::Test
+{
+protected:
+  void TearDown() override
+  {
+    set_fault_policy({});
+  }
+};
+
+TEST_F(faults, off_by_default)
+{
+  const auto site = std::source_location::current();
+  EXPECT_EQ(0.0, get_fault_policy().rate);
+  EXPECT_EQ(std::vector<bool>(100, false), decisions(site, 100));
+}
+
+TEST_F(faults, fails_the_configured_fraction)
+{
+  const auto site = std::source_location::current();
+  set_fault_policy({0.1, 7});
+
+  const auto before = injected_faults();
+  int        failed = 0;
+  for(bool f : decisions(site, 10000))
+  {
+    failed += f;
+  }
+  EXPECT_GT(failed, 800);
+  EXPECT_LT(failed, 1200);
+  EXPECT_EQ(before + failed, injected_faults());
+
+  set_fault_policy({1, 7});
+  EXPECT_EQ(std::vector<bool>(100, true), decisions(site, 100));
+}
+
+TEST_F(faults, deterministic_for_a_seed)
+{
+  const auto site = std::source_location::current();
+  set_fault_policy({0.5, 42});
+  const auto first = decisions(site, 200);
+  set_fault_policy({0.5, 42});
+  EXPECT_EQ(first, decisions(site, 200));
+
+  // a policy applies to every thread from the start of its sequence
+  std::vector<bool> other;
+  std::thread([&] { other = decisions(site, 200); }).join();
+  EXPECT_EQ(first, other);
+
+  set_fault_policy({0.5, 43});
+  EXPECT_NE(first, decisions(site, 200));
+}
+
+TEST_F(faults, keyed_by_call_site)
+{
+  const auto here  = std::source_location::current();
+  const auto there = std::source_location::current();
+  set_fault_policy({0.5, 42});
+  const auto a = decisions(here, 200);
+  set_fault_policy({0.5, 42});
+  EXPECT_NE(a, decisions(there, 200));
+}
+
+TEST_F(faults, clamps_the_rate)
+{
+  set_fault_policy({2, 1});
+  EXPECT_EQ(1.0, get_fault_policy().rate);
+  set_fault_policy({-1, 1});
+  EXPECT_EQ(0.0, get_fault_policy().rate);
+  EXPECT_EQ(1u, get_fault_policy().seed);
+}
+
+// has no default, ok() cannot fail with it
+struct refused
+{
+  explicit refused(int c)
+    : code(c)
+  {
+  }
+
+  int code;
+};
+
+#ifdef RESULTS_FAULTS
+
+TEST_F(faults, ok_fails_with_a_default_error)
+{
+  set_fault_policy({1, 0});
+  auto r = result<int>::ok(1);
+  ASSERT_TRUE(r.is_err());
+  EXPECT_EQ("", r.unwrap_err().msg);
+  EXPECT_TRUE(make_ok<std::string>(here(), 3, 'x').is_err());
+  EXPECT_TRUE((result<int, refused>::ok(1).is_ok()));
+
+  set_fault_policy({0, 0});
+  EXPECT_EQ(1, result<int>::ok(1).unwrap());
+  static_assert(result<int, int>::ok(1).is_ok());
+}
+
+TEST_F(faults, injects_errors_and_nones)
+{
+  set_fault_policy({1, 0});
+  auto r = inject_err(result<int, refused>::ok(1), [] { return refused(7); });
+  EXPECT_EQ(7, r.unwrap_err().code);
+  EXPECT_TRUE(inject_none(option<int>::some(1)).is_none());
+
+  set_fault_policy({0, 0});
+  EXPECT_EQ(1, inject_err(result<int, std::string>::ok(1), [] { return std::string("injected"); }).unwrap());
+  EXPECT_EQ(1, inject_none(option<int>::some(1)).unwrap());
+}
+
+#else
+
+TEST_F(faults, compiled_out)
+{
+  set_fault_policy({1, 0});
+  EXPECT_EQ(1, result<int>::ok(1).unwrap());
+  EXPECT_EQ(1, inject_err(result<int, std::string>::ok(1), [] { return std::string("injected"); }).unwrap());
+  EXPECT_EQ(1, inject_none(option<int>::some(1)).unwrap());
+  static_assert(inject_none(option<int>::some(1)).is_some());
+}
+
+#endif
+
+} // namespace
+} // namespace results
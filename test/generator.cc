@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+#include "generator.hh"
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace results {
+namespace {
+
+result_generator<int, std::string> count_to(int n, int& resumed)
+{
+  for(int i = 1; i <= n; ++i)
+  {
+    ++resumed;
+    co_yield result<int, std::string>::ok(i);
+  }
+}
+
+TEST(result_generator, yields_in_order)
+{
+  int              resumed = 0;
+  std::vector<int> seen;
+  for(auto& r : count_to(3, resumed))
+  {
+    seen.push_back(r.unwrap());
+  }
+  EXPECT_EQ((std::vector<int>{1, 2, 3}), seen);
+}
+
+TEST(result_generator, is_lazy)
+{
+  int  resumed = 0;
+  auto gen     = count_to(3, resumed);
+  EXPECT_EQ(0, resumed);
+
+  auto it = gen.begin();
+  EXPECT_EQ(1, resumed);
+  EXPECT_EQ(1, it->unwrap());
+}
+
+TEST(result_generator, errors_are_elements)
+{
+  auto gen = []() -> result_generator<int, std::string> {
+    co_yield result<int, std::string>::ok(1);
+    co_yield result<int, std::string>::err("bad record");
+    co_yield result<int, std::string>::ok(3);
+  }();
+
+  std::vector<std::string> seen;
+  for(auto& r : gen)
+  {
+    seen.push_back(r.match([](int i) { return std::to_string(i); }, [](const std::string& e) { return e; }));
+  }
+  EXPECT_EQ((std::vector<std::string>{"1", "bad record", "3"}), seen);
+}
+
+TEST(result_generator, stop_with_ends_the_stream)
+{
+  bool resumed_after_stop = false;
+  auto gen                = [&]() -> result_generator<int, std::string> {
+    co_yield result<int, std::string>::ok(1);
+    co_yield stop_with("disk gone");
+    resumed_after_stop = true;
+    co_yield result<int, std::string>::ok(2);
+  }();
+
+  std::vector<result<int, std::string>> seen;
+  for(auto& r : gen)
+  {
+    seen.push_back(r);
+  }
+  ASSERT_EQ(2u, seen.size());
+  EXPECT_EQ(1, seen[0].unwrap());
+  EXPECT_EQ("disk gone", seen[1].unwrap_err());
+  EXPECT_FALSE(resumed_after_stop);
+}
+
+TEST(result_generator, lvalues_are_copied)
+{
+  auto gen = []() -> result_generator<std::string> {
+    auto r = result<std::string>::ok("a");
+    co_yield r;
+    co_yield r;
+  }();
+
+  int count = 0;
+  for(auto& r : gen)
+  {
+    EXPECT_EQ("a", r.unwrap());
+    ++count;
+  }
+  EXPECT_EQ(2, count);
+}
+
+TEST(result_generator, move_only_values)
+{
+  auto gen = []() -> result_generator<std::unique_ptr<int>> {
+    co_yield result<std::unique_ptr<int>>::ok(std::make_unique<int>(42));
+  }();
+
+  auto it    = gen.begin();
+  auto taken = std::move(*it).consume([](auto&& p) { return *p; });
+  EXPECT_EQ(42, taken.unwrap());
+}
+
+TEST(result_generator, exceptions_propagate)
+{
+  auto gen = []() -> result_generator<int> {
+    co_yield result<int>::ok(1);
+    throw std::runtime_error("boom");
+  }();
+
+  auto it = gen.begin();
+  EXPECT_EQ(1, it->unwrap());
+  EXPECT_THROW(++it, std::runtime_error);
+  EXPECT_TRUE(it == gen.end());
+}
+
+TEST(result_generator, frames_are_recycled)
+{
+  void* first = internal::allocate_frame(200);
+  internal::deallocate_frame(first, 200);
+
+  void* second = internal::allocate_frame(250);
+  EXPECT_EQ(first, second);
+  internal::deallocate_frame(second, 250);
+}
+
+} // namespace
+} // namespace results
@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+#include "instrument.hh"
+#include "option.hh"
+#include "result.hh"
+#include <algorithm>
+#include <memory_resource>
+#include <source_location>
+#include <string>
+#include <thread>
+#include <utility>
+
+namespace results {
+namespace {
+
+option<site_count> find_site(const instrumentation_snapshot& s, const std::source_location& site, site_kind kind)
+{
+  auto it = std::find_if(s.sites.begin(), s.sites.end(), [&](const site_count& c) {
+    return c.file == site.file_name() && c.line == site.line() && c.column == site.column() && c.kind == kind;
+  });
+  return it == s.sites.end() ? make_none<site_count>() : make_some<site_count>(*it);
+}
+
+TEST(instrument, counts_are_summed_across_threads)
+{
+  const auto site = std::source_location::current();
+
+  auto count = [&] {
+    for(int i = 0; i < 100; ++i)
+    {
+      internal::count_site(site_kind::err, site);
+    }
+  };
+  std::thread exited(count);
+  exited.join();
+  count();
+
+  auto c = find_site(snapshot_instrumentation(), site, site_kind::err);
+  ASSERT_TRUE(c.is_some());
+  EXPECT_EQ(200u, c.unwrap().count);
+  EXPECT_EQ(site.function_name(), c.unwrap().function);
+  EXPECT_TRUE(find_site(snapshot_instrumentation(), site, site_kind::ok).is_none());
+}
+
+TEST(instrument, panics_keep_the_message)
+{
+  const auto site = std::source_location::current();
+  internal::count_panic("first", site);
+  internal::count_panic("second", site);
+
+  auto s  = snapshot_instrumentation();
+  auto it = std::find_if(s.panics.begin(), s.panics.end(), [&](const panic_count& p) { return p.line == site.line(); });
+  ASSERT_NE(s.panics.end(), it);
+  EXPECT_EQ(2u, it->count);
+  EXPECT_EQ("second", it->message);
+}
+
+#ifdef RESULTS_INSTRUMENT
+
+TEST(instrument, err_and_expect_are_attributed_to_the_caller)
+{
+  const auto site = std::source_location::current();
+  auto       r    = result<int, int>::err(1);
+  EXPECT_THROW(r.expect("must be ok"), panicked);
+
+  auto s = snapshot_instrumentation();
+  EXPECT_TRUE(std::any_of(s.sites.begin(), s.sites.end(), [&](const site_count& c) {
+    return c.kind == site_kind::err && c.file == site.file_name() && c.line == site.line() + 1 && c.count == 1;
+  }));
+  EXPECT_TRUE(std::any_of(s.panics.begin(), s.panics.end(), [&](const panic_count& p) {
+    return p.file == site.file_name() && p.line == site.line() + 2 && p.message == "must be ok";
+  }));
+}
+
+TEST(instrument, multi_argument_forms_are_attributed_through_here)
+{
+  using pair_result = result<std::pair<int, int>, std::pair<int, int>>;
+
+  const auto site = std::source_location::current();
+  auto       ok   = pair_result::ok(here(), 1, 2);
+  auto       err  = make_err<std::pair<int, int>, std::pair<int, int>>(here(), 3, 4);
+  EXPECT_EQ(std::make_pair(1, 2), ok.unwrap());
+  EXPECT_EQ(std::make_pair(3, 4), err.unwrap_err());
+
+  auto s = snapshot_instrumentation();
+  EXPECT_TRUE(find_site(s, site, site_kind::ok).is_none());
+  EXPECT_TRUE(std::any_of(s.sites.begin(), s.sites.end(), [&](const site_count& c) {
+    return c.kind == site_kind::ok && c.file == site.file_name() && c.line == site.line() + 1;
+  }));
+  EXPECT_TRUE(std::any_of(s.sites.begin(), s.sites.end(), [&](const site_count& c) {
+    return c.kind == site_kind::err && c.file == site.file_name() && c.line == site.line() + 2;
+  }));
+}
+
+TEST(instrument, allocator_forms_are_counted)
+{
+  using string_result = result<std::pmr::string, std::pmr::string>;
+  std::pmr::monotonic_buffer_resource arena;
+
+  const auto site = std::source_location::current();
+  auto       ok   = string_result::ok(here(), std::allocator_arg, &arena, "value");
+  auto       err  = string_result::err(here(), std::allocator_arg, &arena, "failure");
+  auto       made = make_ok<std::pmr::string, std::pmr::string>(here(), std::allocator_arg, &arena, "made");
+  EXPECT_EQ(&arena, ok.unwrap().get_allocator().resource());
+  EXPECT_EQ(&arena, err.unwrap_err().get_allocator().resource());
+  EXPECT_EQ("made", made.unwrap());
+
+  auto s       = snapshot_instrumentation();
+  auto counted = [&](site_kind kind, std::uint_least32_t line) {
+    return std::any_of(s.sites.begin(), s.sites.end(), [&](const site_count& c) {
+      return c.kind == kind && c.file == site.file_name() && c.line == line && c.count == 1;
+    });
+  };
+  EXPECT_TRUE(counted(site_kind::ok, site.line() + 1));
+  EXPECT_TRUE(counted(site_kind::err, site.line() + 2));
+  EXPECT_TRUE(counted(site_kind::ok, site.line() + 3));
+}
+
+#endif
+
+} // namespace
+} // namespace results
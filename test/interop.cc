@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+#include "interop.hh"
+#include <optional>
+#include <string>
+#include <system_error>
+
+namespace results {
+namespace {
+
+// counts copies and moves made of any instance
+struct counted
+{
+  static inline int copies = 0;
+  static inline int moves  = 0;
+
+  int value;
+
+  explicit counted(int v)
+    : value(v)
+  {
+  }
+
+  counted(const counted& other)
+    : value(other.value)
+  {
+    ++copies;
+  }
+
+  counted(counted&& other) noexcept
+    : value(other.value)
+  {
+    ++moves;
+  }
+
+  counted& operator=(const counted&) = delete;
+  counted& operator=(counted&&) = delete;
+};
+
+class interop : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    counted::copies = 0;
+    counted::moves  = 0;
+  }
+};
+
+static_assert(from_optional(std::optional<int>(1)).unwrap() == 1);
+static_assert(to_optional(make_some<int>(2)) == std::optional<int>(2));
+
+TEST_F(interop, option_views_its_storage)
+{
+  auto                        o    = make_some<std::string>("a");
+  const std::optional<std::string>& view = o.as_optional();
+  EXPECT_EQ("a", *view);
+  EXPECT_EQ(&o.unwrap(), &*view);
+}
+
+TEST_F(interop, optional_round_trip_moves_once_each_way)
+{
+  auto o = from_optional(std::optional<counted>(std::in_place, 1));
+  EXPECT_EQ(1, counted::moves);
+
+  auto back = to_optional(std::move(o));
+  EXPECT_EQ(1, back->value);
+  EXPECT_EQ(2, counted::moves);
+  EXPECT_EQ(0, counted::copies);
+
+  EXPECT_TRUE(from_optional(std::optional<counted>()).is_none());
+  EXPECT_FALSE(to_optional(make_none<counted>()).has_value());
+}
+
+TEST_F(interop, optional_lvalues_are_copied_once)
+{
+  std::optional<counted> source(std::in_place, 1);
+  auto                   o = from_optional(source);
+  EXPECT_EQ(1, o.unwrap().value);
+  EXPECT_EQ(1, counted::copies);
+  EXPECT_EQ(0, counted::moves);
+}
+
+TEST_F(interop, make_from_error_code)
+{
+  auto ok = make_from_error_code([](std::error_code&) { return 1; });
+  EXPECT_EQ(1, ok.unwrap());
+  EXPECT_FALSE(to_error_code(ok));
+
+  auto err = make_from_error_code([](std::error_code& ec) {
+    ec = std::make_error_code(std::errc::no_such_file_or_directory);
+    return 1;
+  });
+  EXPECT_EQ(std::errc::no_such_file_or_directory, err.unwrap_err());
+  EXPECT_EQ(std::errc::no_such_file_or_directory, to_error_code(err));
+
+  auto from_void = make_from_error_code([](std::error_code&) {});
+  EXPECT_TRUE(from_void.is_ok());
+}
+
+#ifdef __cpp_lib_expected
+
+static_assert(from_expected(std::expected<int, int>(1)).unwrap() == 1);
+static_assert(*to_expected(result<int, int>::ok(2)) == 2);
+
+TEST_F(interop, expected_round_trip_moves_once_each_way)
+{
+  auto r = from_expected(std::expected<counted, int>(std::in_place, 1));
+  EXPECT_EQ(1, counted::moves);
+
+  auto back = to_expected(std::move(r));
+  EXPECT_EQ(1, back->value);
+  EXPECT_EQ(2, counted::moves);
+  EXPECT_EQ(0, counted::copies);
+}
+
+TEST_F(interop, expected_errors)
+{
+  auto r = from_expected(std::expected<int, counted>(std::unexpect, 3));
+  EXPECT_EQ(3, r.unwrap_err().value);
+
+  auto back = to_expected(std::move(r));
+  EXPECT_EQ(3, back.error().value);
+  EXPECT_EQ(0, counted::copies);
+}
+
+#endif
+
+} // namespace
+} // namespace results
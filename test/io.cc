@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+#include "io.hh"
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+namespace results {
+namespace io {
+namespace {
+
+// a fresh directory under the temp directory, removed with everything in it
+class io_test : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    d_dir = std::filesystem::temp_directory_path() /
+            ("results_io_" + std::to_string(::getpid()) + "_" + ::testing::UnitTest::GetInstance()->current_test_info()->name());
+    std::filesystem::create_directories(d_dir);
+  }
+
+  void TearDown() override
+  {
+    std::filesystem::remove_all(d_dir);
+  }
+
+  std::filesystem::path write(const std::string& name, const std::string& content)
+  {
+    auto          path = d_dir / name;
+    std::ofstream out(path, std::ios::binary);
+    out << content;
+    return path;
+  }
+
+  std::filesystem::path d_dir;
+};
+
+TEST_F(io_test, map_file_views_the_content)
+{
+  auto path = write("a.txt", "hello mapped world");
+
+  auto view = map_file(path);
+  ASSERT_TRUE(view.is_ok());
+  EXPECT_EQ("hello mapped world", view.unwrap().text());
+  EXPECT_EQ(18u, view.unwrap().bytes().size());
+}
+
+TEST_F(io_test, map_file_of_an_empty_file)
+{
+  auto view = map_file(write("empty", ""));
+  ASSERT_TRUE(view.is_ok());
+  EXPECT_TRUE(view.unwrap().empty());
+  EXPECT_EQ("", view.unwrap().text());
+}
+
+TEST_F(io_test, map_file_of_a_missing_file)
+{
+  auto view = map_file(d_dir / "missing");
+  ASSERT_TRUE(view.is_err());
+  EXPECT_EQ((sys_error{ENOENT, "open"}), view.unwrap_err());
+  EXPECT_EQ(std::errc::no_such_file_or_directory, view.unwrap_err().error_code());
+  EXPECT_EQ("open: " + std::system_category().message(ENOENT), view.unwrap_err().message());
+}
+
+TEST_F(io_test, mapped_views_move)
+{
+  auto        view = map_file(write("a", "abc"));
+  mapped_view moved(std::move(std::get<0>(std::move(view).as_variant())));
+  EXPECT_EQ("abc", moved.text());
+
+  mapped_view other;
+  other = std::move(moved);
+  EXPECT_EQ("abc", other.text());
+  EXPECT_TRUE(moved.empty());
+}
+
+TEST_F(io_test, read_at_offset)
+{
+  auto f = file::open(write("b", "0123456789"));
+  ASSERT_TRUE(f.is_ok());
+  EXPECT_EQ(10u, f.unwrap().size().unwrap());
+
+  std::array<std::byte, 4> buffer;
+  auto                     n = read_at(f.unwrap(), buffer, 3);
+  ASSERT_EQ(4u, n.unwrap());
+  EXPECT_EQ("3456", std::string_view(reinterpret_cast<const char*>(buffer.data()), 4));
+
+  // short at the end of the file
+  EXPECT_EQ(2u, read_at(f.unwrap(), buffer, 8).unwrap());
+  EXPECT_EQ(0u, read_at(f.unwrap(), buffer, 20).unwrap());
+}
+
+TEST_F(io_test, read_at_a_bad_descriptor)
+{
+  std::array<std::byte, 4> buffer;
+  auto                     n = read_at(-1, buffer, 0);
+  EXPECT_EQ((sys_error{EBADF, "pread"}), n.unwrap_err());
+}
+
+TEST_F(io_test, read_directory_lists_entries)
+{
+  write("x", "1");
+  write("y", "2");
+  std::filesystem::create_directory(d_dir / "sub");
+
+  std::vector<std::string> names;
+  for(auto& entry : read_directory(d_dir))
+  {
+    ASSERT_TRUE(entry.is_ok());
+    const auto& e = entry.unwrap();
+    names.push_back(e.name);
+    if(e.type != entry_type::unknown)
+    {
+      EXPECT_EQ(e.name == "sub" ? entry_type::directory : entry_type::file, e.type);
+    }
+  }
+  std::sort(names.begin(), names.end());
+  EXPECT_EQ((std::vector<std::string>{"sub", "x", "y"}), names);
+}
+
+TEST_F(io_test, read_directory_of_a_missing_directory)
+{
+  std::vector<result<directory_entry, sys_error>> entries;
+  for(auto& entry : read_directory(d_dir / "missing"))
+  {
+    entries.push_back(std::move(entry));
+  }
+  ASSERT_EQ(1u, entries.size());
+  EXPECT_EQ((sys_error{ENOENT, "opendir"}), entries[0].unwrap_err());
+}
+
+} // namespace
+} // namespace io
+} // namespace results
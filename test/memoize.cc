@@ -0,0 +1,202 @@
+#include <gtest/gtest.h>
+#include "memoize.hh"
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace results {
+namespace {
+
+struct fake_clock
+{
+  using duration   = std::chrono::nanoseconds;
+  using rep        = duration::rep;
+  using period     = duration::period;
+  using time_point = std::chrono::time_point<fake_clock>;
+
+  static constexpr bool is_steady = true;
+
+  static inline time_point current{};
+
+  static time_point now() noexcept
+  {
+    return current;
+  }
+
+  static void advance(duration d)
+  {
+    current += d;
+  }
+};
+
+using cache = memoize<int, result<std::string>, std::hash<int>, fake_clock>;
+
+memoize_options options(std::size_t capacity = 16)
+{
+  memoize_options o;
+  o.shards   = 2;
+  o.capacity = capacity;
+  o.ok_ttl   = std::chrono::seconds(10);
+  o.err_ttl  = std::chrono::seconds(1);
+  return o;
+}
+
+// ok for even keys, err for odd ones
+struct counting_lookup
+{
+  std::atomic<int>* calls;
+
+  result<std::string> operator()(int key) const
+  {
+    ++*calls;
+    if(key % 2 == 0)
+    {
+      return make_ok<std::string>(std::to_string(key));
+    }
+    return make_err<std::string>("odd");
+  }
+};
+
+TEST(memoize, computes_once)
+{
+  std::atomic<int> calls{0};
+  cache            c(counting_lookup{&calls}, options());
+
+  EXPECT_EQ("2", c.get(2)->unwrap());
+  EXPECT_EQ("2", c.get(2)->unwrap());
+  EXPECT_EQ(c.get(2), c.get(2));
+  EXPECT_EQ(1, calls);
+}
+
+TEST(memoize, caches_errors)
+{
+  std::atomic<int> calls{0};
+  cache            c(counting_lookup{&calls}, options());
+
+  EXPECT_TRUE(c.get(1)->is_err());
+  EXPECT_TRUE(c.get(1)->is_err());
+  EXPECT_EQ(1, calls);
+}
+
+TEST(memoize, separate_ttls)
+{
+  std::atomic<int> calls{0};
+  cache            c(counting_lookup{&calls}, options());
+
+  c.get(1);
+  c.get(2);
+  EXPECT_EQ(2, calls);
+
+  fake_clock::advance(std::chrono::seconds(2));
+  c.get(1);
+  c.get(2);
+  EXPECT_EQ(3, calls);
+
+  fake_clock::advance(std::chrono::seconds(10));
+  c.get(2);
+  EXPECT_EQ(4, calls);
+}
+
+TEST(memoize, peek)
+{
+  std::atomic<int> calls{0};
+  cache            c(counting_lookup{&calls}, options());
+
+  EXPECT_TRUE(c.peek(2).is_none());
+  c.get(2);
+  EXPECT_EQ("2", c.peek(2).unwrap()->unwrap());
+  EXPECT_EQ(1, calls);
+
+  fake_clock::advance(std::chrono::seconds(11));
+  EXPECT_TRUE(c.peek(2).is_none());
+}
+
+TEST(memoize, invalidate)
+{
+  std::atomic<int> calls{0};
+  cache            c(counting_lookup{&calls}, options());
+
+  c.get(2);
+  c.invalidate(2);
+  EXPECT_EQ(0, c.size());
+  c.get(2);
+  EXPECT_EQ(2, calls);
+}
+
+TEST(memoize, evicts_least_recently_used)
+{
+  std::atomic<int> calls{0};
+  cache            c(counting_lookup{&calls}, options(4));
+
+  for(int i = 0; i < 100; ++i)
+  {
+    c.get(i);
+  }
+  EXPECT_GE(4, c.size());
+
+  // evicted entries stay valid for whoever holds them
+  auto held = c.get(1000);
+  for(int i = 0; i < 100; ++i)
+  {
+    c.get(i);
+  }
+  EXPECT_EQ("1000", held->unwrap());
+}
+
+TEST(memoize, exceptions_are_not_cached)
+{
+  int   calls = 0;
+  cache c([&](int) -> result<std::string> {
+    if(++calls == 1)
+    {
+      throw std::runtime_error("booh");
+    }
+    return make_ok<std::string>("fine");
+  },
+          options());
+
+  EXPECT_THROW(c.get(1), std::runtime_error);
+  EXPECT_EQ("fine", c.get(1)->unwrap());
+}
+
+TEST(memoize, single_flight)
+{
+  std::atomic<int>  calls{0};
+  std::atomic<bool> release{false};
+  cache             c([&](int key) {
+    ++calls;
+    while(!release)
+    {
+      std::this_thread::yield();
+    }
+    return make_ok<std::string>(std::to_string(key));
+  },
+          options());
+
+  std::vector<std::thread> threads;
+  std::atomic<int>         done{0};
+  for(int i = 0; i < 8; ++i)
+  {
+    threads.emplace_back([&] {
+      EXPECT_EQ("7", c.get(7)->unwrap());
+      ++done;
+    });
+  }
+
+  while(calls == 0)
+  {
+    std::this_thread::yield();
+  }
+  release = true;
+  for(auto&& t : threads)
+  {
+    t.join();
+  }
+  EXPECT_EQ(1, calls);
+  EXPECT_EQ(8, done);
+}
+
+} // namespace
+} // namespace results
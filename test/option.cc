@@ -3,6 +3,7 @@
 #include <stdexcept>
 #include <string>
 #include <type_traits>
+#include <unordered_map>
 
 namespace results {
 namespace {
@@ -30,6 +31,14 @@ TEST(option, unwrap)
   EXPECT_EQ(2, make_some<int>(2).unwrap());
 }
 
+TEST(option, unwrap_unchecked)
+{
+  EXPECT_EQ(2, make_some<int>(2).unwrap_unchecked());
+#if RESULTS_VERIFY_UNCHECKED
+  EXPECT_THROW(make_none<int>().unwrap_unchecked(), panicked);
+#endif
+}
+
 TEST(option, unwrap_or)
 {
   EXPECT_EQ(2, make_some<int>(2).unwrap_or(3));
@@ -198,5 +207,61 @@ TEST(option, use_moved_into)
   EXPECT_EQ(42, val);
 }
 
+TEST(option, equality)
+{
+  EXPECT_EQ(make_some<int>(1), make_some<int>(1));
+  EXPECT_EQ(make_none<int>(), make_none<int>());
+  EXPECT_NE(make_some<int>(1), make_some<int>(2));
+  EXPECT_NE(make_some<int>(1), make_none<int>());
+}
+
+TEST(option, ordering)
+{
+  EXPECT_LT(make_none<int>(), make_some<int>(1));
+  EXPECT_LT(make_some<int>(1), make_some<int>(2));
+  EXPECT_GT(make_some<int>(2), make_some<int>(1));
+  EXPECT_LE(make_none<int>(), make_none<int>());
+  EXPECT_GE(make_some<int>(1), make_none<int>());
+  EXPECT_FALSE(make_none<int>() < make_none<int>());
+}
+
+TEST(option, mixed_comparison)
+{
+  EXPECT_TRUE(make_some<int>(1) == 1);
+  EXPECT_TRUE(1 == make_some<int>(1));
+  EXPECT_TRUE(make_none<int>() != 1);
+  EXPECT_TRUE(make_none<int>() < 1);
+  EXPECT_TRUE(1 > make_none<int>());
+  EXPECT_TRUE(make_some<int>(1) < 2);
+  EXPECT_TRUE(2 >= make_some<int>(2));
+  EXPECT_TRUE(make_some<std::string>("a") == "a");
+}
+
+TEST(option, hash)
+{
+  std::hash<option<int>> h;
+  EXPECT_EQ(h(make_some<int>(1)), h(make_some<int>(1)));
+  EXPECT_NE(h(make_some<int>(1)), h(make_some<int>(2)));
+  EXPECT_NE(h(make_some<int>(0)), h(make_none<int>()));
+  EXPECT_NE(h(make_some<int>(2)), h(make_none<int>()));
+
+  std::unordered_map<option<std::string>, int> m;
+  m[make_some<std::string>("a")] = 1;
+  m[make_none<std::string>()]    = 2;
+
+  EXPECT_EQ(1, m.at(make_some<std::string>("a")));
+  EXPECT_EQ(2, m.at(make_none<std::string>()));
+}
+
+struct unhashable
+{
+};
+
+TEST(option, hash_of_unhashable_is_disabled)
+{
+  static_assert(std::is_default_constructible_v<std::hash<option<int>>>);
+  static_assert(!std::is_default_constructible_v<std::hash<option<unhashable>>>);
+}
+
 } // namespace
 } // namespace results
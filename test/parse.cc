@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+#include "parse.hh"
+#include <cstdint>
+#include <string_view>
+#include <utility>
+
+namespace results {
+
+enum class color {
+  red,
+  blue,
+};
+
+enum class level : std::uint8_t {
+  low  = 1,
+  high = 2,
+};
+
+template <>
+struct enum_names<color>
+{
+  static constexpr std::pair<std::string_view, color> values[] = {
+      {"red", color::red},
+      {"blue", color::blue},
+  };
+};
+
+namespace {
+
+TEST(parse, integer)
+{
+  EXPECT_EQ(42, parse<int>("42").unwrap());
+  EXPECT_EQ(-7, parse<int>("-7").unwrap());
+  EXPECT_EQ(255, parse<std::uint8_t>("255").unwrap());
+}
+
+TEST(parse, integer_errors)
+{
+  EXPECT_EQ((parse_error{0, parse_errc::empty}), parse<int>("").unwrap_err());
+  EXPECT_EQ((parse_error{0, parse_errc::invalid}), parse<int>("abc").unwrap_err());
+  EXPECT_EQ((parse_error{0, parse_errc::invalid}), parse<int>(" 1").unwrap_err());
+  EXPECT_EQ((parse_error{0, parse_errc::out_of_range}), parse<std::uint8_t>("256").unwrap_err());
+  EXPECT_EQ((parse_error{2, parse_errc::trailing_characters}), parse<int>("12x").unwrap_err());
+}
+
+TEST(parse, floating_point)
+{
+  EXPECT_DOUBLE_EQ(1.5, parse<double>("1.5").unwrap());
+  EXPECT_DOUBLE_EQ(-2e3, parse<double>("-2e3").unwrap());
+  EXPECT_FLOAT_EQ(0.25f, parse<float>("0.25").unwrap());
+
+  EXPECT_EQ((parse_error{0, parse_errc::invalid}), parse<double>("x").unwrap_err());
+  EXPECT_EQ((parse_error{3, parse_errc::trailing_characters}), parse<double>("1.5 ").unwrap_err());
+  EXPECT_EQ((parse_error{0, parse_errc::out_of_range}), parse<float>("1e99").unwrap_err());
+}
+
+TEST(parse, boolean)
+{
+  EXPECT_TRUE(parse<bool>("true").unwrap());
+  EXPECT_TRUE(parse<bool>("1").unwrap());
+  EXPECT_FALSE(parse<bool>("false").unwrap());
+  EXPECT_FALSE(parse<bool>("0").unwrap());
+
+  EXPECT_EQ((parse_error{0, parse_errc::invalid}), parse<bool>("yes").unwrap_err());
+}
+
+TEST(parse, enum_by_name)
+{
+  EXPECT_EQ(color::red, parse<color>("red").unwrap());
+  EXPECT_EQ(color::blue, parse<color>("blue").unwrap());
+
+  EXPECT_EQ((parse_error{0, parse_errc::invalid}), parse<color>("green").unwrap_err());
+}
+
+TEST(parse, enum_by_value)
+{
+  EXPECT_EQ(level::high, parse<level>("2").unwrap());
+  EXPECT_EQ((parse_error{0, parse_errc::out_of_range}), parse<level>("1000").unwrap_err());
+}
+
+TEST(parse, message)
+{
+  EXPECT_EQ("trailing characters", parse<int>("1x").unwrap_err().message());
+}
+
+} // namespace
+} // namespace results
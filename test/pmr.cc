@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+#include "pmr.hh"
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+namespace results {
+namespace {
+
+constexpr auto long_msg = "a message long enough to defeat the small string optimization";
+
+class counting_resource : public std::pmr::memory_resource
+{
+public:
+  std::size_t allocations   = 0;
+  std::size_t deallocations = 0;
+
+private:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override
+  {
+    ++allocations;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+  {
+    ++deallocations;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+  {
+    return this == &other;
+  }
+};
+
+static_assert(std::uses_allocator_v<pmr::result<int>, std::pmr::polymorphic_allocator<char>>);
+static_assert(std::uses_allocator_v<result<std::pmr::string, int>, std::pmr::polymorphic_allocator<char>>);
+static_assert(!std::uses_allocator_v<result<int>, std::pmr::polymorphic_allocator<char>>);
+static_assert(std::uses_allocator_v<option<std::pmr::string>, std::pmr::polymorphic_allocator<char>>);
+static_assert(!std::uses_allocator_v<option<int>, std::pmr::polymorphic_allocator<char>>);
+
+TEST(pmr, make_err_with_allocator)
+{
+  counting_resource res;
+  {
+    auto r = make_err<int, pmr::error>(std::allocator_arg, &res, long_msg);
+
+    EXPECT_EQ(long_msg, r.unwrap_err().msg);
+    EXPECT_EQ(&res, r.unwrap_err().get_allocator().resource());
+    EXPECT_EQ(1, res.allocations);
+  }
+  EXPECT_EQ(1, res.deallocations);
+}
+
+TEST(pmr, make_err_with_allocator_and_no_message)
+{
+  counting_resource res;
+  auto              r = make_err<int, pmr::error>(std::allocator_arg, &res);
+
+  EXPECT_EQ("", r.unwrap_err().msg);
+  EXPECT_EQ(&res, r.unwrap_err().get_allocator().resource());
+}
+
+TEST(pmr, make_ok_with_allocator)
+{
+  counting_resource res;
+  auto              r = make_ok<std::pmr::string, pmr::error>(std::allocator_arg, &res, long_msg);
+
+  EXPECT_EQ(long_msg, r.unwrap());
+  EXPECT_EQ(&res, r.unwrap().get_allocator().resource());
+  EXPECT_EQ(1, res.allocations);
+}
+
+TEST(pmr, allocator_is_ignored_by_types_that_do_not_use_one)
+{
+  counting_resource res;
+  auto              ok  = make_ok<int, pmr::error>(std::allocator_arg, &res, 42);
+  auto              err = make_err<std::string, int>(std::allocator_arg, &res, 42);
+
+  EXPECT_EQ(42, ok.unwrap());
+  EXPECT_EQ(42, err.unwrap_err());
+  EXPECT_EQ(0, res.allocations);
+}
+
+TEST(pmr, make_some_with_allocator)
+{
+  counting_resource res;
+  auto              o = make_some<std::pmr::string>(std::allocator_arg, &res, long_msg);
+
+  EXPECT_EQ(long_msg, o.unwrap());
+  EXPECT_EQ(&res, o.unwrap().get_allocator().resource());
+  EXPECT_EQ(1, res.allocations);
+}
+
+TEST(pmr, container_propagates_to_result)
+{
+  counting_resource                   res;
+  std::pmr::vector<pmr::result<int>> v(&res);
+  v.reserve(2);
+
+  auto err = make_err<int, pmr::error>(long_msg);
+  v.push_back(err);
+  v.push_back(make_err<int, pmr::error>(long_msg));
+  v.push_back(make_ok<int, pmr::error>(1));
+
+  // 2 reserves + 2 messages
+  EXPECT_EQ(4, res.allocations);
+  for(auto&& r : v)
+  {
+    r.match(
+        [](int) {},
+        [&](auto&& e) { EXPECT_EQ(&res, e.get_allocator().resource()); });
+  }
+}
+
+TEST(pmr, container_propagates_to_option)
+{
+  counting_resource                             res;
+  std::pmr::vector<option<std::pmr::string>> v(&res);
+  v.reserve(2);
+
+  v.push_back(make_some<std::pmr::string>(long_msg));
+  v.push_back(make_none<std::pmr::string>());
+
+  EXPECT_EQ(2, res.allocations);
+  EXPECT_EQ(&res, v[0].unwrap().get_allocator().resource());
+}
+
+TEST(pmr, combinators_keep_the_allocator_of_errors)
+{
+  counting_resource res;
+  {
+    const auto r = make_err<int, pmr::error>(std::allocator_arg, &res, long_msg);
+
+    auto chained = r.and_then([](int v) { return pmr::result<int>::ok(v + 1); });
+    auto mapped  = r.map([](int v) { return v * 2; });
+    auto both    = chained.and_then([](int v) { return result<int, pmr::error, int>::ok(v); }).map([](int v) { return v; });
+
+    EXPECT_EQ(&res, chained.unwrap_err().get_allocator().resource());
+    EXPECT_EQ(&res, mapped.unwrap_err().get_allocator().resource());
+    EXPECT_EQ(&res, both.unwrap_err<pmr::error>().get_allocator().resource());
+    EXPECT_EQ(long_msg, both.unwrap_err<pmr::error>().msg);
+    // the original, one copy per combinator and the temporary between the last two
+    EXPECT_EQ(5, res.allocations);
+  }
+  EXPECT_EQ(5, res.deallocations);
+}
+
+TEST(pmr, arena_release)
+{
+  counting_resource                   upstream;
+  std::pmr::monotonic_buffer_resource arena(&upstream);
+
+  for(int i = 0; i < 100; ++i)
+  {
+    auto r = make_err<int, pmr::error>(std::allocator_arg, &arena, long_msg);
+    EXPECT_TRUE(r.is_err());
+  }
+  EXPECT_LT(0, upstream.allocations);
+
+  arena.release();
+  EXPECT_EQ(upstream.allocations, upstream.deallocations);
+}
+
+} // namespace
+} // namespace results
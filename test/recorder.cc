@@ -0,0 +1,197 @@
+#include <gtest/gtest.h>
+#include "recorder.hh"
+#include "parse.hh"
+#include "result.hh"
+#include <algorithm>
+#include <memory_resource>
+#include <source_location>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+
+namespace results {
+namespace {
+
+std::vector<error_record> records_at(const std::source_location& site)
+{
+  auto records = dump_error_records();
+  records.erase(std::remove_if(records.begin(),
+                               records.end(),
+                               [&](const error_record& r) { return r.file != site.file_name() || r.line != site.line(); }),
+                records.end());
+  return records;
+}
+
+class recorder : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    clear_error_records();
+  }
+};
+
+TEST_F(recorder, records_site_code_and_message)
+{
+  const auto site = std::source_location::current();
+  internal::record_error(record_kind::err, site, 42, "disk full");
+
+  auto records = records_at(site);
+  ASSERT_EQ(1u, records.size());
+  EXPECT_EQ(record_kind::err, records[0].kind);
+  EXPECT_EQ(site.function_name(), records[0].function);
+  EXPECT_EQ(site.column(), records[0].column);
+  EXPECT_EQ(42, records[0].code);
+  EXPECT_EQ("disk full", records[0].message);
+}
+
+TEST_F(recorder, truncates_long_messages)
+{
+  const auto site = std::source_location::current();
+  internal::record_error(record_kind::panic, site, 0, std::string(500, 'x'));
+
+  auto records = records_at(site);
+  ASSERT_EQ(1u, records.size());
+  EXPECT_EQ(std::string(error_record::max_message, 'x'), records[0].message);
+}
+
+TEST_F(recorder, keeps_the_most_recent_records)
+{
+  const auto site = std::source_location::current();
+  for(int i = 0; i < 5000; ++i)
+  {
+    internal::record_error(record_kind::err, site, i, "");
+  }
+
+  auto records = records_at(site);
+  ASSERT_FALSE(records.empty());
+  EXPECT_LT(records.size(), 5000u);
+  EXPECT_EQ(4999, records.back().code);
+  EXPECT_EQ(5000 - static_cast<std::int64_t>(records.size()), records.front().code);
+}
+
+TEST_F(recorder, merges_threads_by_time_and_keeps_exited_ones)
+{
+  const auto site = std::source_location::current();
+  internal::record_error(record_kind::err, site, 1, "");
+  std::thread([&] { internal::record_error(record_kind::err, site, 2, ""); }).join();
+  internal::record_error(record_kind::err, site, 3, "");
+
+  auto records = records_at(site);
+  ASSERT_EQ(3u, records.size());
+  EXPECT_EQ(1, records[0].code);
+  EXPECT_EQ(2, records[1].code);
+  EXPECT_EQ(3, records[2].code);
+  EXPECT_NE(records[0].thread, records[1].thread);
+  EXPECT_EQ(records[0].thread, records[2].thread);
+  EXPECT_LE(records[0].timestamp, records[1].timestamp);
+  EXPECT_LE(records[1].timestamp, records[2].timestamp);
+}
+
+TEST_F(recorder, clear_hides_earlier_records)
+{
+  const auto site = std::source_location::current();
+  internal::record_error(record_kind::err, site, 1, "");
+  clear_error_records();
+  EXPECT_TRUE(records_at(site).empty());
+}
+
+// what() by value: a view of it would dangle once the summary is returned
+struct formatted_error
+{
+  std::string what() const
+  {
+    return "formatted on demand";
+  }
+};
+
+// an owning string of another type by value dangles just the same
+struct arena_error
+{
+  std::pmr::string message() const
+  {
+    return "formatted into an arena";
+  }
+};
+
+// a reference to a string the error holds stays valid
+struct stored_error
+{
+  std::string text;
+
+  const std::string& what() const
+  {
+    return text;
+  }
+};
+
+TEST(recorder_summary, of_common_error_types)
+{
+  EXPECT_EQ(7, internal::summarize_error(7).code);
+  EXPECT_EQ(static_cast<std::int64_t>(parse_errc::invalid), internal::summarize_error(parse_errc::invalid).code);
+  EXPECT_EQ("boom", internal::summarize_error(error("boom")).message);
+  EXPECT_EQ("bad", std::string(internal::summarize_error(std::runtime_error("bad")).message));
+
+  auto code = internal::summarize_error(std::make_error_code(std::errc::timed_out));
+  EXPECT_EQ(static_cast<int>(std::errc::timed_out), code.code);
+  EXPECT_EQ("generic", code.message);
+
+  parse_error p{0, parse_errc::empty};
+  EXPECT_EQ(p.message(), internal::summarize_error(p).message);
+}
+
+TEST(recorder_summary, skips_strings_returned_by_value)
+{
+  static_assert(internal::has_what_v<formatted_error>);
+  static_assert(!internal::has_what_view_v<formatted_error>);
+  EXPECT_TRUE(internal::summarize_error(formatted_error{}).message.empty());
+
+  static_assert(!internal::has_message_view_v<arena_error>);
+  EXPECT_TRUE(internal::summarize_error(arena_error{}).message.empty());
+
+  static_assert(internal::has_what_view_v<stored_error>);
+  stored_error stored{"kept"};
+  EXPECT_EQ("kept", internal::summarize_error(stored).message);
+}
+
+#ifdef RESULTS_RECORD
+
+TEST_F(recorder, err_make_from_throwable_and_panic_are_recorded)
+{
+  const auto err_site = std::source_location::current();
+  auto       r        = result<int, int>::err(5, err_site);
+  const auto exc_site = std::source_location::current();
+  auto       t        = make_from_throwable([]() -> int { throw std::runtime_error("thrown"); }, exc_site);
+  const auto pan_site = std::source_location::current();
+  EXPECT_THROW(r.expect("must be ok", pan_site), panicked);
+
+  auto err = records_at(err_site);
+  ASSERT_EQ(1u, err.size());
+  EXPECT_EQ(5, err[0].code);
+
+  auto exc = records_at(exc_site);
+  ASSERT_EQ(1u, exc.size());
+  EXPECT_EQ("thrown", exc[0].message);
+
+  auto pan = records_at(pan_site);
+  ASSERT_EQ(1u, pan.size());
+  EXPECT_EQ(record_kind::panic, pan[0].kind);
+  EXPECT_EQ("must be ok", pan[0].message);
+}
+
+TEST_F(recorder, multi_argument_err_is_recorded_at_the_caller)
+{
+  const auto site = std::source_location::current();
+  auto       r    = result<int, std::runtime_error>::err(here(site), "refused");
+  EXPECT_TRUE(r.is_err());
+
+  auto records = records_at(site);
+  ASSERT_EQ(1u, records.size());
+  EXPECT_EQ("refused", records[0].message);
+}
+
+#endif
+
+} // namespace
+} // namespace results
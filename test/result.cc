@@ -3,6 +3,8 @@
 #include <stdexcept>
 #include <string>
 #include <type_traits>
+#include <unordered_map>
+#include <variant>
 
 namespace results {
 namespace {
@@ -50,6 +52,22 @@ TEST(result, unwrap_err)
   EXPECT_EQ("something", make_err<int>("something").unwrap_err().msg);
 }
 
+TEST(result, unwrap_unchecked)
+{
+  EXPECT_EQ(1, make_ok<int>(1).unwrap_unchecked());
+#if RESULTS_VERIFY_UNCHECKED
+  EXPECT_THROW(make_err<int>("booh").unwrap_unchecked(), panicked);
+#endif
+}
+
+TEST(result, unwrap_err_unchecked)
+{
+  EXPECT_EQ("something", make_err<int>("something").unwrap_err_unchecked().msg);
+#if RESULTS_VERIFY_UNCHECKED
+  EXPECT_THROW(make_ok<int>(1).unwrap_err_unchecked(), panicked);
+#endif
+}
+
 TEST(result, unwrap_or)
 {
   auto ok  = make_ok<int>(1);
@@ -182,6 +200,188 @@ TEST(result, make_from_throwable)
   EXPECT_EQ("non-std exception", make_from_throwable(throws_nonstd).unwrap_err().msg);
 }
 
+TEST(result, make_from_throwable_noexcept)
+{
+  auto ok = []() noexcept { return 1; };
+
+  EXPECT_EQ(1, make_from_throwable(ok).unwrap());
+}
+
+TEST(result, make_from_exception)
+{
+  auto ok = [] { return 1; };
+  auto throws_std = [] { throw std::out_of_range("booh!"); return 1; };
+  auto throws_nonstd = [] { throw 42; return 1; };
+
+  EXPECT_EQ(1, make_from_exception(ok).unwrap());
+
+  auto std_err = make_from_exception(throws_std).unwrap_err();
+  EXPECT_STREQ("booh!", std_err.what());
+  EXPECT_NE(nullptr, std_err.get_if<std::out_of_range>());
+  EXPECT_NE(nullptr, std_err.get_if<std::logic_error>());
+  EXPECT_EQ(nullptr, std_err.get_if<std::runtime_error>());
+  EXPECT_THROW(std_err.rethrow(), std::out_of_range);
+
+  auto nonstd_err = make_from_exception(throws_nonstd).unwrap_err();
+  EXPECT_STREQ("non-std exception", nonstd_err.what());
+  EXPECT_EQ(42, *nonstd_err.get_if<int>());
+}
+
+TEST(result, exception_error_moves_its_exception)
+{
+  auto err   = make_from_exception([] { throw std::out_of_range("booh!"); return 1; }).unwrap_err();
+  auto moved = std::move(err);
+  EXPECT_STREQ("booh!", moved.what());
+  EXPECT_NE(nullptr, moved.get_if<std::logic_error>());
+  EXPECT_STREQ("non-std exception", err.what());
+  EXPECT_EQ(nullptr, err.get_if<std::logic_error>());
+  EXPECT_EQ(nullptr, err.get_if<int>());
+
+  exception_error empty(nullptr);
+  EXPECT_STREQ("non-std exception", empty.what());
+}
+
+TEST(result, make_from_exception_rethrows_same_object)
+{
+  auto throws = [] { throw std::runtime_error("booh!"); return 1; };
+  auto err    = make_from_exception(throws).unwrap_err();
+
+  try
+  {
+    err.rethrow();
+  }
+  catch(const std::runtime_error& e)
+  {
+    EXPECT_EQ(err.get_if<std::runtime_error>(), &e);
+  }
+}
+
+TEST(result, equality)
+{
+  EXPECT_EQ(make_ok<int>(1), make_ok<int>(1));
+  EXPECT_EQ(make_err<int>("e"), make_err<int>("e"));
+  EXPECT_NE(make_ok<int>(1), make_ok<int>(2));
+  EXPECT_NE(make_err<int>("e"), make_err<int>("f"));
+  EXPECT_NE((make_ok<int, int>(1)), (make_err<int, int>(1)));
+}
+
+TEST(result, ordering)
+{
+  EXPECT_LT(make_ok<int>(1), make_ok<int>(2));
+  EXPECT_LT((make_ok<int, int>(2)), (make_err<int, int>(1)));
+  EXPECT_LT((make_err<int, int>(1)), (make_err<int, int>(2)));
+  EXPECT_GT((make_err<int, int>(1)), (make_ok<int, int>(2)));
+  EXPECT_LE(make_ok<int>(1), make_ok<int>(1));
+  EXPECT_GE((make_err<int, int>(1)), (make_err<int, int>(1)));
+}
+
+TEST(result, mixed_comparison)
+{
+  EXPECT_TRUE(make_ok<int>(1) == 1);
+  EXPECT_TRUE(1 == make_ok<int>(1));
+  EXPECT_TRUE(make_err<int>("e") != 1);
+  EXPECT_TRUE(make_ok<int>(1) < 2);
+  EXPECT_TRUE(1 < make_err<int>("e"));
+  EXPECT_TRUE(make_err<int>("e") > 1);
+  EXPECT_TRUE(make_ok<std::string>("a") == "a");
+}
+
+TEST(result, hash)
+{
+  std::hash<result<int, int>> h;
+  EXPECT_EQ(h(make_ok<int, int>(1)), h(make_ok<int, int>(1)));
+  EXPECT_NE(h(make_ok<int, int>(1)), h(make_err<int, int>(1)));
+  for(int x = 0; x < 1000; ++x)
+  {
+    EXPECT_NE(h(make_ok<int, int>(x)), h(make_err<int, int>(x ^ 2)));
+  }
+
+  std::unordered_map<result<std::string>, int> m;
+  m[make_ok<std::string>("a")]  = 1;
+  m[make_err<std::string>("a")] = 2;
+
+  EXPECT_EQ(1, m.at(make_ok<std::string>("a")));
+  EXPECT_EQ(2, m.at(make_err<std::string>("a")));
+}
+
+struct parse_failure
+{
+  int position;
+};
+
+struct io_failure
+{
+  std::string path;
+};
+
+using layered = result<int, parse_failure, io_failure>;
+
+static_assert(sizeof(layered) == sizeof(std::variant<int, parse_failure, io_failure>));
+static_assert(std::is_same_v<layered::error_type, parse_failure>);
+
+TEST(result, multiple_errors_select_by_type)
+{
+  auto p = layered::err(parse_failure{3});
+  auto i = layered::err(io_failure{"a"});
+
+  EXPECT_TRUE(p.holds_err<parse_failure>());
+  EXPECT_FALSE(p.holds_err<io_failure>());
+  EXPECT_EQ(3, p.unwrap_err().position);
+  EXPECT_EQ("a", i.unwrap_err<io_failure>().path);
+  EXPECT_THROW(i.unwrap_err<parse_failure>(), panicked);
+}
+
+TEST(result, multiple_errors_widen)
+{
+  layered r = result<int, io_failure>::err(io_failure{"a"});
+  EXPECT_EQ("a", r.unwrap_err<io_failure>().path);
+
+  layered ok = result<int, parse_failure>::ok(1);
+  EXPECT_EQ(1, ok.unwrap());
+}
+
+TEST(result, and_then_widens_to_union_of_errors)
+{
+  auto parse = [](int i) { return i > 0 ? result<int, parse_failure>::ok(i) : result<int, parse_failure>::err(parse_failure{i}); };
+  auto read  = [](int i) { return i < 10 ? result<int, io_failure>::ok(i * 2) : result<int, io_failure>::err(io_failure{"big"}); };
+
+  auto r = parse(1).and_then(read);
+  static_assert(std::is_same_v<decltype(r), result<int, parse_failure, io_failure>>);
+  EXPECT_EQ(2, r.unwrap());
+
+  EXPECT_EQ(-1, parse(-1).and_then(read).unwrap_err<parse_failure>().position);
+  EXPECT_EQ("big", parse(10).and_then(read).unwrap_err<io_failure>().path);
+
+  // no duplicates in the union
+  auto again = r.and_then(read);
+  static_assert(std::is_same_v<decltype(again), result<int, parse_failure, io_failure>>);
+}
+
+TEST(result, match_handles_every_error)
+{
+  auto describe = [](const layered& r) {
+    return r.match([](int i) { return std::to_string(i); },
+                   overloaded{
+                       [](const parse_failure& p) { return "parse " + std::to_string(p.position); },
+                       [](const io_failure& i) { return "io " + i.path; },
+                   });
+  };
+
+  EXPECT_EQ("1", describe(layered::ok(1)));
+  EXPECT_EQ("parse 2", describe(layered::err(parse_failure{2})));
+  EXPECT_EQ("io a", describe(layered::err(io_failure{"a"})));
+}
+
+TEST(result, multiple_errors_map_err)
+{
+  auto r = layered::err(io_failure{"abc"}).map_err(overloaded{
+      [](const parse_failure&) { return std::size_t(0); },
+      [](const io_failure& i) { return i.path.size(); },
+  });
+  static_assert(std::is_same_v<decltype(r), result<int, std::size_t>>);
+  EXPECT_EQ(3u, r.unwrap_err());
+}
+
 TEST(option, map_to_work_with_void_returning)
 {
   int val = 0;
@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+#include "recorder.hh"
+#include "result_array.hh"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace results {
+namespace {
+
+using array = result_array<int, std::string>;
+
+// every seventh element fails, spread over several bitmap words
+array sample(std::size_t n)
+{
+  array a;
+  for(std::size_t i = 0; i < n; ++i)
+  {
+    if(i % 7 == 3)
+    {
+      a.emplace_err("bad " + std::to_string(i));
+    }
+    else
+    {
+      a.emplace_ok(static_cast<int>(i));
+    }
+  }
+  return a;
+}
+
+TEST(result_array, stores_values_densely_and_errors_aside)
+{
+  auto a = sample(200);
+  EXPECT_EQ(200u, a.size());
+  EXPECT_EQ(29u, a.error_count());
+  EXPECT_EQ(200u, a.values().size());
+  EXPECT_EQ(4u, a.error_bits().size());
+
+  EXPECT_TRUE(a.is_ok(0));
+  EXPECT_TRUE(a.is_err(3));
+  EXPECT_TRUE(a.is_err(199));
+  EXPECT_EQ(0, a.values()[3]);
+  EXPECT_EQ(11, a.value_unchecked(11));
+  EXPECT_EQ("bad 66", a.error_unchecked(66));
+}
+
+TEST(result_array, reads_back_results)
+{
+  auto a = sample(100);
+  EXPECT_EQ(5, a[5].unwrap());
+  EXPECT_EQ("bad 10", a[10].unwrap_err());
+
+  auto r = a.ref(10);
+  EXPECT_EQ(&a.error_unchecked(10), &r.unwrap_err().get());
+  EXPECT_EQ(&a.values()[5], &a.ref(5).unwrap().get());
+
+  auto v = a.to_vector();
+  ASSERT_EQ(100u, v.size());
+  for(std::size_t i = 0; i < v.size(); ++i)
+  {
+    EXPECT_TRUE(v[i] == a[i]);
+  }
+}
+
+TEST(result_array, reading_back_produces_no_errors)
+{
+  auto a = sample(100);
+  clear_error_records();
+  for(int i = 0; i < 3; ++i)
+  {
+    EXPECT_TRUE(a[10].is_err());
+    EXPECT_TRUE(a.ref(10).is_err());
+  }
+  EXPECT_EQ(100u, a.to_vector().size());
+
+  EXPECT_TRUE(dump_error_records().empty());
+  for(const auto& s : snapshot_instrumentation().sites)
+  {
+    EXPECT_EQ(std::string_view::npos, s.file.find("result_array.hh"));
+  }
+}
+
+TEST(result_array, push_back_results)
+{
+  array a;
+  a.push_back(array::value_type::ok(1));
+  a.push_back(array::value_type::err("x"));
+  const auto ok = array::value_type::ok(3);
+  a.push_back(ok);
+
+  EXPECT_EQ(1, a[0].unwrap());
+  EXPECT_EQ("x", a[1].unwrap_err());
+  EXPECT_EQ(3, a[2].unwrap());
+}
+
+TEST(result_array, set_err_keeps_the_side_table_ordered)
+{
+  auto a = sample(30);
+  a.set_err(0, "first");
+  a.set_err(20, "middle");
+  a.set_err(3, "replaced");
+
+  EXPECT_EQ(6u, a.error_count());
+  EXPECT_EQ("first", a[0].unwrap_err());
+  EXPECT_EQ("middle", a[20].unwrap_err());
+  EXPECT_EQ("replaced", a[3].unwrap_err());
+  EXPECT_EQ("bad 24", a[24].unwrap_err());
+
+  auto errors = a.errors();
+  EXPECT_TRUE(std::is_sorted(errors.begin(), errors.end(), [](const auto& l, const auto& r) { return l.first < r.first; }));
+}
+
+TEST(result_array, map_skips_failed_elements)
+{
+  auto a = sample(150);
+  auto m = a.map([](int v) { return v * 2.5; });
+  static_assert(std::is_same_v<decltype(m), result_array<double, std::string>>);
+
+  ASSERT_EQ(a.size(), m.size());
+  for(std::size_t i = 0; i < a.size(); ++i)
+  {
+    if(a.is_ok(i))
+    {
+      EXPECT_EQ(a[i].unwrap() * 2.5, m[i].unwrap());
+    }
+    else
+    {
+      EXPECT_EQ(a[i].unwrap_err(), m[i].unwrap_err());
+    }
+  }
+}
+
+TEST(result_array, for_each_ok_visits_ok_elements_in_order)
+{
+  auto                     a = sample(130);
+  std::vector<std::size_t> visited;
+  a.for_each_ok([&](std::size_t i, int v) {
+    EXPECT_EQ(static_cast<int>(i), v);
+    visited.push_back(i);
+  });
+
+  EXPECT_EQ(a.size() - a.error_count(), visited.size());
+  EXPECT_TRUE(std::is_sorted(visited.begin(), visited.end()));
+  EXPECT_EQ(128u, visited.back()); // 129 failed
+}
+
+TEST(result_array, clear)
+{
+  auto a = sample(10);
+  a.clear();
+  EXPECT_TRUE(a.empty());
+  EXPECT_EQ(0u, a.error_count());
+  a.emplace_ok(1);
+  EXPECT_EQ(1, a[0].unwrap());
+}
+
+} // namespace
+} // namespace results
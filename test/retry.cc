@@ -0,0 +1,273 @@
+#include <gtest/gtest.h>
+#include "retry.hh"
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <stop_token>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace results {
+namespace {
+
+using namespace std::chrono_literals;
+
+// Virtual time: when the executor sleeps until a timer, the clock jumps to it. Waits without a timer block on the
+// condition variable as usual.
+struct fake_clock
+{
+  using duration   = std::chrono::nanoseconds;
+  using rep        = duration::rep;
+  using period     = duration::period;
+  using time_point = std::chrono::time_point<fake_clock>;
+
+  static constexpr bool is_steady = true;
+
+  static inline std::atomic<rep> current{0};
+
+  static time_point now() noexcept
+  {
+    return time_point(duration(current.load()));
+  }
+
+  static void wait_until(std::condition_variable& cv, std::unique_lock<std::mutex>& lock, time_point tp)
+  {
+    if(tp == time_point::max())
+    {
+      cv.wait_for(lock, std::chrono::hours(1));
+      return;
+    }
+    auto target = tp.time_since_epoch().count();
+    auto now    = current.load();
+    while(now < target && !current.compare_exchange_weak(now, target))
+    {
+    }
+  }
+};
+
+using executor = retry_executor<fake_clock>;
+
+struct transient
+{
+  bool        retryable;
+  std::string what;
+};
+
+bool is_retryable(const transient& e)
+{
+  return e.retryable;
+}
+
+retry_policy no_jitter()
+{
+  retry_policy p;
+  p.max_attempts    = 3;
+  p.initial_backoff = 10ms;
+  p.multiplier      = 2;
+  p.jitter          = 0;
+  return p;
+}
+
+class retry : public ::testing::Test
+{
+protected:
+  thread_pool pool{2};
+};
+
+TEST_F(retry, ok_on_first_attempt)
+{
+  executor ex(pool, no_jitter());
+  auto     r = ex.run([] { return result<int, transient>::ok(1); }, is_retryable);
+
+  EXPECT_EQ(1, r.unwrap());
+  EXPECT_EQ(1u, ex.stats().attempts);
+  EXPECT_EQ(0u, ex.stats().retries);
+}
+
+TEST_F(retry, retries_with_exponential_backoff)
+{
+  executor         ex(pool, no_jitter());
+  std::atomic<int> calls{0};
+  auto             start = fake_clock::now();
+
+  auto r = ex.run(
+      [&] {
+        return ++calls < 3 ? result<int, transient>::err(transient{true, "busy"}) : result<int, transient>::ok(3);
+      },
+      is_retryable);
+
+  EXPECT_EQ(3, r.unwrap());
+  EXPECT_EQ(3, calls.load());
+  EXPECT_TRUE(fake_clock::now() - start == 10ms + 20ms);
+
+  auto stats = ex.stats();
+  EXPECT_EQ(3u, stats.attempts);
+  EXPECT_EQ(2u, stats.retries);
+  EXPECT_EQ(2u, stats.err);
+  EXPECT_EQ(1u, stats.ok);
+}
+
+TEST_F(retry, jitter_shortens_the_backoff)
+{
+  auto policy         = no_jitter();
+  policy.jitter       = 0.5;
+  policy.max_attempts = 2;
+  executor ex(pool, policy, 42);
+  auto     start = fake_clock::now();
+
+  ex.run([] { return result<int, transient>::err(transient{true, "busy"}); }, is_retryable);
+
+  auto waited = fake_clock::now() - start;
+  EXPECT_TRUE(waited >= 5ms);
+  EXPECT_TRUE(waited <= 10ms);
+}
+
+TEST_F(retry, stops_on_non_retryable_errors)
+{
+  executor         ex(pool, no_jitter());
+  std::atomic<int> calls{0};
+
+  auto r = ex.run(
+      [&] {
+        ++calls;
+        return result<int, transient>::err(transient{false, "bad request"});
+      },
+      is_retryable);
+
+  EXPECT_EQ("bad request", r.unwrap_err().what);
+  EXPECT_EQ(1, calls.load());
+}
+
+TEST_F(retry, rethrows_without_retrying)
+{
+  executor         ex(pool, no_jitter());
+  std::atomic<int> calls{0};
+
+  EXPECT_THROW(ex.run(
+                   [&]() -> result<int, transient> {
+                     ++calls;
+                     throw std::runtime_error("connection reset");
+                   },
+                   is_retryable),
+               std::runtime_error);
+  EXPECT_EQ(1, calls.load());
+
+  auto stats = ex.stats();
+  EXPECT_EQ(1u, stats.attempts);
+  EXPECT_EQ(1u, stats.err);
+  EXPECT_EQ(0u, stats.retries);
+}
+
+TEST_F(retry, fails_once_the_pool_is_shut_down)
+{
+  executor         ex(pool, no_jitter());
+  std::atomic<int> calls{0};
+  pool.shutdown();
+  pool.shutdown();
+
+  auto r = ex.run(
+      [&] {
+        ++calls;
+        return result<int, transient>::ok(1);
+      },
+      is_retryable);
+  EXPECT_TRUE(r.holds_err<pool_closed>());
+  EXPECT_EQ(0, calls.load());
+  EXPECT_EQ(0u, ex.stats().attempts);
+}
+
+TEST_F(retry, gives_up_after_max_attempts)
+{
+  executor         ex(pool, no_jitter());
+  std::atomic<int> calls{0};
+
+  auto r = ex.run(
+      [&] { return result<int, transient>::err(transient{true, std::to_string(++calls)}); }, is_retryable);
+
+  EXPECT_EQ("3", r.unwrap_err().what);
+  EXPECT_EQ(3, calls.load());
+}
+
+TEST_F(retry, hedges_slow_attempts)
+{
+  // virtual time passes instantly, more attempts could hedge again before either one ran
+  auto policy         = no_jitter();
+  policy.hedge_after  = 50ms;
+  policy.max_attempts = 2;
+  executor ex(pool, policy);
+
+  std::atomic<int>   calls{0};
+  std::promise<void> first_cancelled;
+
+  auto r = ex.run(
+      [&](std::stop_token token) {
+        if(++calls == 1)
+        {
+          // the slow attempt, runs until the call no longer needs it
+          while(!token.stop_requested())
+          {
+            std::this_thread::yield();
+          }
+          first_cancelled.set_value();
+          return result<int, transient>::ok(1);
+        }
+        return result<int, transient>::ok(2);
+      },
+      is_retryable);
+
+  EXPECT_EQ(2, r.unwrap());
+  first_cancelled.get_future().wait();
+
+  // the abandoned attempt records its stats after the call returned
+  while(ex.stats().attempts < 2)
+  {
+    std::this_thread::yield();
+  }
+  auto stats = ex.stats();
+  EXPECT_EQ(1u, stats.hedges);
+  EXPECT_EQ(1u, stats.abandoned);
+  EXPECT_EQ(2u, stats.ok);
+}
+
+TEST_F(retry, enforces_the_deadline)
+{
+  auto policy     = no_jitter();
+  policy.deadline = 1s;
+  executor ex(pool, policy);
+  auto     start = fake_clock::now();
+
+  auto r = ex.run(
+      [](std::stop_token token) {
+        while(!token.stop_requested())
+        {
+          std::this_thread::yield();
+        }
+        return result<int, transient>::ok(1);
+      },
+      is_retryable);
+
+  EXPECT_TRUE(r.holds_err<deadline_exceeded>());
+  EXPECT_TRUE(fake_clock::now() - start == 1s);
+}
+
+TEST(attempt_stats, percentiles)
+{
+  attempt_stats s;
+  for(int i = 0; i < 99; ++i)
+  {
+    s.record(100ns, true, false);
+  }
+  s.record(1ms, false, false);
+
+  // durations are compared without printing them, gtest would need the C++20 chrono stream operators
+  EXPECT_EQ(128, s.percentile(0.5).count());
+  EXPECT_EQ(128, s.percentile(0.99).count());
+  EXPECT_TRUE(s.max_latency == 1ms);
+  EXPECT_TRUE(s.percentile(1) >= 1ms);
+  EXPECT_EQ(100u, s.attempts);
+  EXPECT_EQ(1u, s.err);
+}
+
+} // namespace
+} // namespace results
@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+#include "trace.hh"
+#include "result.hh"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+namespace results {
+namespace {
+
+std::vector<trace_event> events_named(std::string_view name)
+{
+  auto events = snapshot_trace();
+  events.erase(std::remove_if(events.begin(), events.end(), [&](const trace_event& e) { return e.name != name; }),
+               events.end());
+  return events;
+}
+
+class trace : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    clear_trace();
+  }
+};
+
+TEST_F(trace, records_name_duration_and_outcome)
+{
+  const auto start = internal::timestamp();
+  internal::record_span("parse", start, start + 1000, span_outcome::err);
+
+  auto events = events_named("parse");
+  ASSERT_EQ(1u, events.size());
+  EXPECT_EQ(span_outcome::err, events[0].outcome);
+  EXPECT_GT(events[0].duration, 0u);
+  EXPECT_LT(events[0].duration, 1000000u);
+}
+
+TEST_F(trace, keeps_the_most_recent_spans)
+{
+  const auto start = internal::timestamp();
+  for(std::uint64_t i = 0; i < 10000; ++i)
+  {
+    internal::record_span("spin", start + i, start + i + 1, span_outcome::ok);
+  }
+
+  auto events = events_named("spin");
+  EXPECT_GE(events.size(), 1000u);
+  EXPECT_LT(events.size(), 10000u);
+  EXPECT_TRUE(std::is_sorted(events.begin(), events.end(), [](const trace_event& l, const trace_event& r) {
+    return l.start < r.start;
+  }));
+}
+
+TEST_F(trace, keeps_spans_of_exited_threads)
+{
+  internal::record_span("here", internal::timestamp(), internal::timestamp(), span_outcome::none);
+  std::thread([] { internal::record_span("there", internal::timestamp(), internal::timestamp(), span_outcome::ok); }).join();
+
+  auto here  = events_named("here");
+  auto there = events_named("there");
+  ASSERT_EQ(1u, here.size());
+  ASSERT_EQ(1u, there.size());
+  EXPECT_NE(here[0].thread, there[0].thread);
+}
+
+TEST_F(trace, clear_forgets_earlier_spans)
+{
+  internal::record_span("old", internal::timestamp(), internal::timestamp(), span_outcome::ok);
+  clear_trace();
+  EXPECT_TRUE(events_named("old").empty());
+}
+
+TEST_F(trace, writes_chrome_trace_events)
+{
+  const auto start = internal::timestamp();
+  internal::record_span("load \"config\"", start, start + 10, span_outcome::ok);
+  internal::record_span("plain", start + 20, start + 30, span_outcome::none);
+
+  std::ostringstream out;
+  write_chrome_trace(out);
+  const auto json = out.str();
+
+  EXPECT_EQ(0u, json.find("{\"traceEvents\":["));
+  EXPECT_NE(std::string::npos, json.find("\"name\":\"load \\\"config\\\"\",\"cat\":\"result\",\"ph\":\"X\""));
+  EXPECT_NE(std::string::npos, json.find("\"args\":{\"outcome\":\"ok\"}"));
+  EXPECT_NE(std::string::npos, json.find("\"pid\":" + std::to_string(::getpid())));
+
+  std::size_t count = 0;
+  for(auto at = json.find("\"ph\":\"X\""); at != std::string::npos; at = json.find("\"ph\":\"X\"", at + 1))
+  {
+    ++count;
+  }
+  EXPECT_EQ(2u, count);
+  EXPECT_EQ(std::string::npos, json.find("\"outcome\"", json.find("plain")));
+}
+
+TEST_F(trace, exports_to_a_file)
+{
+  internal::record_span("export", internal::timestamp(), internal::timestamp(), span_outcome::err);
+  const auto path = std::filesystem::temp_directory_path() / ("results_trace_" + std::to_string(::getpid()) + ".json");
+
+  auto written = export_chrome_trace(path);
+  ASSERT_TRUE(written.is_ok());
+
+  std::ifstream in(path);
+  std::string   content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  EXPECT_EQ(content.size(), written.unwrap());
+  EXPECT_NE(std::string::npos, content.find("\"outcome\":\"err\""));
+  std::filesystem::remove(path);
+
+  auto failed = export_chrome_trace("/nonexistent/dir/trace.json");
+  ASSERT_TRUE(failed.is_err());
+  EXPECT_EQ(ENOENT, failed.unwrap_err().code);
+}
+
+TEST(trace_outcome, of_results_and_other_values)
+{
+  EXPECT_EQ(span_outcome::ok, outcome_of(result<int, int>::ok(1)));
+  EXPECT_EQ(span_outcome::err, outcome_of(result<int, int>::err(1)));
+  EXPECT_EQ(span_outcome::none, outcome_of(1));
+}
+
+#ifdef RESULTS_TRACE
+
+TEST_F(trace, traced_steps_of_a_chain)
+{
+  auto parse = [](int v) { return v > 0 ? result<int, int>::ok(v) : result<int, int>::err(v); };
+  auto twice = [](int v) { return v * 2; };
+
+  auto r = result<int, int>::ok(3).and_then(traced("parse", parse)).map(traced("twice", twice));
+  EXPECT_EQ(6, r.unwrap());
+  result<int, int>::ok(-1).and_then(traced("parse", parse)).map(traced("twice", twice));
+
+  auto parses = events_named("parse");
+  ASSERT_EQ(2u, parses.size());
+  EXPECT_EQ(span_outcome::ok, parses[0].outcome);
+  EXPECT_EQ(span_outcome::err, parses[1].outcome);
+
+  auto doubles = events_named("twice");
+  ASSERT_EQ(1u, doubles.size());
+  EXPECT_EQ(span_outcome::none, doubles[0].outcome);
+}
+
+TEST_F(trace, span_covers_its_scope)
+{
+  {
+    trace_span span("scope");
+    span.set_outcome(span_outcome::err);
+  }
+  auto events = events_named("scope");
+  ASSERT_EQ(1u, events.size());
+  EXPECT_EQ(span_outcome::err, events[0].outcome);
+}
+
+#else
+
+TEST_F(trace, compiled_out)
+{
+  static_assert(std::is_empty_v<trace_span>);
+
+  auto f = [](int v) { return v + 1; };
+  static_assert(std::is_same_v<decltype(f), decltype(traced("f", f))>);
+  EXPECT_EQ(2, traced("f", f)(1));
+  {
+    trace_span span("scope");
+  }
+  EXPECT_TRUE(events_named("f").empty());
+  EXPECT_TRUE(events_named("scope").empty());
+}
+
+#endif
+
+} // namespace
+} // namespace results